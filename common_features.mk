@@ -54,11 +54,25 @@ ifeq ($(MUSIC_ENABLE), 1)
     SRC += $(QUANTUM_DIR)/process_keycode/process_music.c
 endif
 
+ifeq ($(strip $(SPARSE_KEYMAP_ENABLE)), yes)
+    OPT_DEFS += -DSPARSE_KEYMAP_ENABLE
+endif
+
+ifeq ($(strip $(MATRIX_SLEEP_ENABLE)), yes)
+    OPT_DEFS += -DMATRIX_SLEEP_ENABLE
+    SRC += $(QUANTUM_DIR)/matrix_sleep.c
+endif
+
 ifeq ($(strip $(COMBO_ENABLE)), yes)
     OPT_DEFS += -DCOMBO_ENABLE
     SRC += $(QUANTUM_DIR)/process_keycode/process_combo.c
 endif
 
+ifeq ($(strip $(POSITIONAL_COMBO_ENABLE)), yes)
+    OPT_DEFS += -DPOSITIONAL_COMBO_ENABLE
+    SRC += $(QUANTUM_DIR)/process_keycode/process_positional_combo.c
+endif
+
 ifeq ($(strip $(STENO_ENABLE)), yes)
     OPT_DEFS += -DSTENO_ENABLE
     VIRTSER_ENABLE := yes
@@ -233,6 +247,16 @@ QUANTUM_SRC:= \
     $(QUANTUM_DIR)/keycode_config.c \
     $(QUANTUM_DIR)/process_keycode/process_leader.c
 
+DEBOUNCE_DIR:= $(QUANTUM_DIR)/debounce
+DEBOUNCE_TYPE?= sym_g
+VALID_DEBOUNCE_TYPES := sym_g sym_pr sym_pk eager_pk custom
+ifeq ($(filter $(strip $(DEBOUNCE_TYPE)),$(VALID_DEBOUNCE_TYPES)),)
+    $(error DEBOUNCE_TYPE="$(DEBOUNCE_TYPE)" is not a valid debounce algorithm)
+endif
+ifneq ($(strip $(DEBOUNCE_TYPE)), custom)
+    QUANTUM_SRC += $(DEBOUNCE_DIR)/$(strip $(DEBOUNCE_TYPE)).c
+endif
+
 ifndef CUSTOM_MATRIX
     ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
         QUANTUM_SRC += $(QUANTUM_DIR)/split_common/matrix.c
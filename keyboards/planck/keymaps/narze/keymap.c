@@ -444,7 +444,7 @@ void music_scale_user(void)
 
 // Combos
 
-void process_combo_event(uint8_t combo_index, bool pressed) {
+void process_combo_event(combo_id_t combo_index, bool pressed) {
   if (pressed) {
     switch(combo_index) {
       case CB_SUPERDUPER:
@@ -0,0 +1,46 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Set 0 if debouncing isn't needed */
+#ifndef DEBOUNCING_DELAY
+#   define DEBOUNCING_DELAY 5
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The debounce algorithm is picked with DEBOUNCE_TYPE in rules.mk, see
+ * quantum/debounce/. The matrix reads the switches into raw, and debounce()
+ * updates cooked, the state the rest of the firmware sees. changed is true
+ * when raw differs from the previous scan.
+ */
+void debounce_init(uint8_t num_rows);
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+bool debounce_active(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,111 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Per-key eager debounce: a change of a key is committed on the scan that
+ * sees it, and the key is then locked for DEBOUNCING_DELAY ms so that its
+ * bounces are ignored. A state that differs once the lock ends is committed
+ * right away. Lowest latency, but noise spikes are reported as presses.
+ */
+
+#include "debounce.h"
+#include "timer.h"
+
+#if (DEBOUNCING_DELAY > 255)
+#   error "DEBOUNCING_DELAY must be 255 or less for per-key debounce"
+#endif
+
+/* ms left in each key's lock, 0 when the key is free */
+static uint8_t counters[MATRIX_ROWS * MATRIX_COLS];
+/* counters running, wide enough to count every key of the matrix */
+#if (MATRIX_ROWS * MATRIX_COLS > 255)
+static uint16_t active_counters = 0;
+#else
+static uint8_t active_counters = 0;
+#endif
+static uint16_t last_time;
+
+void debounce_init(uint8_t num_rows)
+{
+    for (uint16_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        counters[i] = 0;
+    }
+    active_counters = 0;
+    last_time = timer_read();
+}
+
+static uint8_t elapsed_since_last_scan(void)
+{
+    uint16_t elapsed = timer_elapsed(last_time);
+    last_time += elapsed;
+    return elapsed > 255 ? 255 : elapsed;
+}
+
+/* Release every lock that runs out within elapsed ms */
+static void update_counters(uint8_t num_rows, uint8_t elapsed)
+{
+    uint8_t *counter = counters;
+    for (uint16_t i = 0; i < num_rows * MATRIX_COLS; i++, counter++) {
+        if (!*counter) continue;
+        if (*counter <= elapsed) {
+            *counter = 0;
+            active_counters--;
+        } else {
+            *counter -= elapsed;
+        }
+    }
+}
+
+/* Commit and lock every free key whose raw state differs */
+static void transfer_changes(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows)
+{
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        uint8_t *counter = &counters[row * MATRIX_COLS];
+        for (uint8_t col = 0; delta; delta >>= 1, col++, counter++) {
+            if ((delta & 1) && !*counter) {
+                cooked[row] ^= (matrix_row_t)1 << col;
+                *counter = DEBOUNCING_DELAY;
+                active_counters++;
+            }
+        }
+    }
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed)
+{
+#if (DEBOUNCING_DELAY > 0)
+    uint8_t elapsed = elapsed_since_last_scan();
+    bool locked = active_counters;
+    if (locked && elapsed) {
+        update_counters(num_rows, elapsed);
+    }
+    // a key leaving its lock may differ without a new change, so look again
+    if (changed || locked) {
+        transfer_changes(raw, cooked, num_rows);
+    }
+#else
+    if (changed) {
+        for (uint8_t i = 0; i < num_rows; i++) {
+            cooked[i] = raw[i];
+        }
+    }
+#endif
+}
+
+bool debounce_active(void)
+{
+    return active_counters;
+}
@@ -0,0 +1,67 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Global deferred debounce: one timer for the whole matrix. Any change
+ * restarts it, and the raw matrix is committed once nothing has changed for
+ * DEBOUNCING_DELAY ms.
+ */
+
+#include "debounce.h"
+#include "timer.h"
+
+#if (DEBOUNCING_DELAY > 0)
+static uint16_t debouncing_time;
+static bool debouncing = false;
+#endif
+
+void debounce_init(uint8_t num_rows)
+{
+#if (DEBOUNCING_DELAY > 0)
+    debouncing = false;
+#endif
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed)
+{
+#if (DEBOUNCING_DELAY > 0)
+    if (changed) {
+        debouncing = true;
+        debouncing_time = timer_read();
+    }
+
+    if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
+        for (uint8_t i = 0; i < num_rows; i++) {
+            cooked[i] = raw[i];
+        }
+        debouncing = false;
+    }
+#else
+    if (changed) {
+        for (uint8_t i = 0; i < num_rows; i++) {
+            cooked[i] = raw[i];
+        }
+    }
+#endif
+}
+
+bool debounce_active(void)
+{
+#if (DEBOUNCING_DELAY > 0)
+    return debouncing;
+#else
+    return false;
+#endif
+}
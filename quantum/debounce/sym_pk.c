@@ -0,0 +1,116 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Per-key deferred debounce: every key has its own timer. A change of a key
+ * restarts only that key's timer, and the key is committed once it has been
+ * stable for DEBOUNCING_DELAY ms, so a chattering key does not delay others.
+ */
+
+#include "debounce.h"
+#include "timer.h"
+
+#if (DEBOUNCING_DELAY > 255)
+#   error "DEBOUNCING_DELAY must be 255 or less for per-key debounce"
+#endif
+
+/* ms left before each key is committed, 0 when the key is stable */
+static uint8_t counters[MATRIX_ROWS * MATRIX_COLS];
+static matrix_row_t last_raw[MATRIX_ROWS];
+/* counters running, wide enough to count every key of the matrix */
+#if (MATRIX_ROWS * MATRIX_COLS > 255)
+static uint16_t active_counters = 0;
+#else
+static uint8_t active_counters = 0;
+#endif
+static uint16_t last_time;
+
+void debounce_init(uint8_t num_rows)
+{
+    for (uint16_t i = 0; i < MATRIX_ROWS * MATRIX_COLS; i++) {
+        counters[i] = 0;
+    }
+    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+        last_raw[i] = 0;
+    }
+    active_counters = 0;
+    last_time = timer_read();
+}
+
+static uint8_t elapsed_since_last_scan(void)
+{
+    uint16_t elapsed = timer_elapsed(last_time);
+    last_time += elapsed;
+    return elapsed > 255 ? 255 : elapsed;
+}
+
+/* Commit every key whose timer runs out within elapsed ms */
+static void update_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed)
+{
+    uint8_t *counter = counters;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++, counter++) {
+            if (!*counter) continue;
+            if (*counter <= elapsed) {
+                matrix_row_t mask = (matrix_row_t)1 << col;
+                cooked[row] = (cooked[row] & ~mask) | (raw[row] & mask);
+                *counter = 0;
+                active_counters--;
+            } else {
+                *counter -= elapsed;
+            }
+        }
+    }
+}
+
+/* Restart the timer of every key that changed since the last scan */
+static void start_counters(matrix_row_t raw[], uint8_t num_rows)
+{
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ last_raw[row];
+        last_raw[row] = raw[row];
+        uint8_t *counter = &counters[row * MATRIX_COLS];
+        for (; delta; delta >>= 1, counter++) {
+            if (delta & 1) {
+                if (!*counter) active_counters++;
+                *counter = DEBOUNCING_DELAY;
+            }
+        }
+    }
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed)
+{
+#if (DEBOUNCING_DELAY > 0)
+    uint8_t elapsed = elapsed_since_last_scan();
+    if (active_counters && elapsed) {
+        update_counters(raw, cooked, num_rows, elapsed);
+    }
+    if (changed) {
+        start_counters(raw, num_rows);
+    }
+#else
+    if (changed) {
+        for (uint8_t i = 0; i < num_rows; i++) {
+            cooked[i] = raw[i];
+        }
+    }
+#endif
+}
+
+bool debounce_active(void)
+{
+    return active_counters;
+}
@@ -0,0 +1,82 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Per-row deferred debounce: every row has its own timer. A change restarts
+ * the timer of its row only, and a row is committed once it has been stable
+ * for DEBOUNCING_DELAY ms, so chatter only delays the keys on its own row.
+ */
+
+#include "debounce.h"
+#include "timer.h"
+
+#if (DEBOUNCING_DELAY > 0)
+static uint16_t row_times[MATRIX_ROWS];
+static matrix_row_t last_raw[MATRIX_ROWS];
+static bool debouncing = false;
+#endif
+
+void debounce_init(uint8_t num_rows)
+{
+#if (DEBOUNCING_DELAY > 0)
+    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+        last_raw[i] = 0;
+    }
+    debouncing = false;
+#endif
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed)
+{
+#if (DEBOUNCING_DELAY > 0)
+    if (changed) {
+        uint16_t now = timer_read();
+        for (uint8_t i = 0; i < num_rows; i++) {
+            if (raw[i] != last_raw[i]) {
+                last_raw[i] = raw[i];
+                row_times[i] = now;
+            }
+        }
+        debouncing = true;
+    }
+
+    if (debouncing) {
+        debouncing = false;
+        for (uint8_t i = 0; i < num_rows; i++) {
+            if (raw[i] == cooked[i]) continue;
+            if (timer_elapsed(row_times[i]) > DEBOUNCING_DELAY) {
+                cooked[i] = raw[i];
+            } else {
+                debouncing = true;
+            }
+        }
+    }
+#else
+    if (changed) {
+        for (uint8_t i = 0; i < num_rows; i++) {
+            cooked[i] = raw[i];
+        }
+    }
+#endif
+}
+
+bool debounce_active(void)
+{
+#if (DEBOUNCING_DELAY > 0)
+    return debouncing;
+#else
+    return false;
+#endif
+}
@@ -94,7 +94,7 @@ void dynamic_macro_play(
 {
     dprintf("dynamic macro: slot %d playback\n", DYNAMIC_MACRO_CURRENT_SLOT());
 
-    uint32_t saved_layer_state = layer_state;
+    layer_state_t saved_layer_state = layer_state;
 
     clear_keyboard();
     layer_clear();
@@ -18,8 +18,31 @@
 
 extern keymap_config_t keymap_config;
 
+/* options that change what keycode_config() returns */
+static const keymap_config_t keycode_remap_options = {
+    .swap_control_capslock = true,
+    .capslock_to_control = true,
+    .swap_lalt_lgui = true,
+    .swap_ralt_rgui = true,
+    .no_gui = true,
+    .swap_grave_esc = true,
+    .swap_backslash_backspace = true,
+};
+
+/* options that change what mod_config() returns */
+static const keymap_config_t mod_remap_options = {
+    .swap_lalt_lgui = true,
+    .swap_ralt_rgui = true,
+    .no_gui = true,
+};
+
 uint16_t keycode_config(uint16_t keycode) {
 
+    /* most keymaps set none of the options, skip the switch then */
+    if (!(keymap_config.raw & keycode_remap_options.raw)) {
+        return keycode;
+    }
+
     switch (keycode) {
         case KC_CAPSLOCK:
         case KC_LOCKING_CAPS:
@@ -90,6 +113,9 @@ uint16_t keycode_config(uint16_t keycode) {
 }
 
 uint8_t mod_config(uint8_t mod) {
+    if (!(keymap_config.raw & mod_remap_options.raw)) {
+        return mod;
+    }
     if (keymap_config.swap_lalt_lgui) {
         if ((mod & MOD_RGUI) == MOD_LGUI) {
             mod &= ~MOD_LGUI;
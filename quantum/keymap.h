@@ -52,5 +52,45 @@ uint16_t keymap_function_id_to_action( uint16_t function_id );
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
 extern const uint16_t fn_actions[];
 
+#ifdef SPARSE_KEYMAP_ENABLE
+/* Sparse layers list only their non-transparent keys, sorted by key index.
+ * Every other key of a sparse layer is KC_TRNS.
+ *
+ *   const sparse_key_t PROGMEM fn_layer[] = {
+ *       SPARSE_KEY(0, 1, KC_F1),
+ *       SPARSE_KEY(0, 2, KC_F2),
+ *   };
+ *   SPARSE_KEYMAPS(
+ *       [1] = SPARSE_LAYER(fn_layer),
+ *   );
+ *
+ * Layers without a SPARSE_LAYER() are read from keymaps[] as before.
+ */
+#if MATRIX_ROWS * MATRIX_COLS <= 256
+typedef uint8_t sparse_key_index_t;
+#else
+typedef uint16_t sparse_key_index_t;
+#endif
+
+typedef struct {
+    sparse_key_index_t key;
+    uint16_t keycode;
+} sparse_key_t;
+
+typedef struct {
+    const sparse_key_t *keys;
+    uint16_t count;
+} sparse_layer_t;
+
+#define SPARSE_KEY(row, col, kc) { .key = (row) * MATRIX_COLS + (col), .keycode = (kc) }
+#define SPARSE_LAYER(layer_keys) { .keys = (layer_keys), .count = sizeof(layer_keys) / sizeof((layer_keys)[0]) }
+#define SPARSE_KEYMAPS(...) \
+    const sparse_layer_t PROGMEM sparse_keymaps[] = { __VA_ARGS__ }; \
+    const uint8_t sparse_keymaps_count = sizeof(sparse_keymaps) / sizeof(sparse_keymaps[0])
+
+extern const sparse_layer_t sparse_keymaps[];
+extern const uint8_t sparse_keymaps_count;
+#endif
+
 
 #endif
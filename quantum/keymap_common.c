@@ -41,17 +41,10 @@ extern keymap_config_t keymap_config;
 
 #include <inttypes.h>
 
-/* converts key to action */
-action_t action_for_key(uint8_t layer, keypos_t key)
+/* keycodes 0x0000-0x00FF: basic, system, consumer and mouse keys */
+static action_t decode_basic(uint16_t keycode)
 {
-    // 16bit keycodes - important
-    uint16_t keycode = keymap_key_to_keycode(layer, key);
-
-    // keycode remapping
-    keycode = keycode_config(keycode);
-
     action_t action;
-    uint8_t action_layer, when, mod;
 
     switch (keycode) {
         case KC_FN0 ... KC_FN31:
@@ -73,112 +66,198 @@ action_t action_for_key(uint8_t layer, keypos_t key)
         case KC_TRNS:
             action.code = ACTION_TRANSPARENT;
             break;
-        case QK_MODS ... QK_MODS_MAX: ;
+        default:
+            action.code = ACTION_NO;
+            break;
+    }
+    return action;
+}
+
+/* loose quantum keycodes from 0x5C00 that map to an action */
+static action_t decode_quantum(uint16_t keycode)
+{
+    action_t action;
+
+    switch (keycode) {
+    #ifdef BACKLIGHT_ENABLE
+        case BL_ON:
+            action.code = ACTION_BACKLIGHT_ON();
+            #ifdef SPLIT_KEYBOARD
+                BACKLIT_DIRTY = true;
+            #endif
+            break;
+        case BL_OFF:
+            action.code = ACTION_BACKLIGHT_OFF();
+            #ifdef SPLIT_KEYBOARD
+                BACKLIT_DIRTY = true;
+            #endif
+            break;
+        case BL_DEC:
+            action.code = ACTION_BACKLIGHT_DECREASE();
+            #ifdef SPLIT_KEYBOARD
+                BACKLIT_DIRTY = true;
+            #endif
+            break;
+        case BL_INC:
+            action.code = ACTION_BACKLIGHT_INCREASE();
+            #ifdef SPLIT_KEYBOARD
+                BACKLIT_DIRTY = true;
+            #endif
+            break;
+        case BL_TOGG:
+            action.code = ACTION_BACKLIGHT_TOGGLE();
+            #ifdef SPLIT_KEYBOARD
+                BACKLIT_DIRTY = true;
+            #endif
+            break;
+        case BL_STEP:
+            action.code = ACTION_BACKLIGHT_STEP();
+            #ifdef SPLIT_KEYBOARD
+                BACKLIT_DIRTY = true;
+            #endif
+            break;
+    #endif
+        default:
+            action.code = ACTION_NO;
+            break;
+    }
+    return action;
+}
+
+/* keycode decoders, one per keycode range */
+enum keycode_decoder {
+    DECODE_NO = 0,
+    DECODE_BASIC,
+    DECODE_MODS,
+    DECODE_FUNCTION,
+    DECODE_MACRO,
+    DECODE_LAYER_TAP,
+    DECODE_TO,
+    DECODE_MOMENTARY,
+    DECODE_DEF_LAYER,
+    DECODE_TOGGLE_LAYER,
+    DECODE_ONE_SHOT_LAYER,
+    DECODE_ONE_SHOT_MOD,
+    DECODE_LAYER_TAP_TOGGLE,
+    DECODE_LAYER_MOD,
+    DECODE_SWAP_HANDS,
+    DECODE_QUANTUM,
+    DECODE_MOD_TAP,
+};
+
+/* decoder of each keycode high byte, keycodes from 0x8000 (unicode) have no action */
+static const uint8_t PROGMEM keycode_decoder_by_high_byte[0x80] = {
+    [QK_TMK >> 8]                                               = DECODE_BASIC,
+    [QK_MODS >> 8 ... QK_MODS_MAX >> 8]                         = DECODE_MODS,
+    [QK_FUNCTION >> 8 ... QK_FUNCTION_MAX >> 8]                 = DECODE_FUNCTION,
+    [QK_MACRO >> 8 ... QK_MACRO_MAX >> 8]                       = DECODE_MACRO,
+    [QK_LAYER_TAP >> 8 ... QK_LAYER_TAP_MAX >> 8]               = DECODE_LAYER_TAP,
+    [QK_TO >> 8]                                                = DECODE_TO,
+    [QK_MOMENTARY >> 8]                                         = DECODE_MOMENTARY,
+    [QK_DEF_LAYER >> 8]                                         = DECODE_DEF_LAYER,
+    [QK_TOGGLE_LAYER >> 8]                                      = DECODE_TOGGLE_LAYER,
+    [QK_ONE_SHOT_LAYER >> 8]                                    = DECODE_ONE_SHOT_LAYER,
+    [QK_ONE_SHOT_MOD >> 8]                                      = DECODE_ONE_SHOT_MOD,
+    [QK_LAYER_TAP_TOGGLE >> 8]                                  = DECODE_LAYER_TAP_TOGGLE,
+    [QK_LAYER_MOD >> 8]                                         = DECODE_LAYER_MOD,
+#ifdef SWAP_HANDS_ENABLE
+    [QK_SWAP_HANDS >> 8]                                        = DECODE_SWAP_HANDS,
+#endif
+    [RESET >> 8 ... (QK_MOD_TAP >> 8) - 1]                      = DECODE_QUANTUM,
+    [QK_MOD_TAP >> 8 ... QK_MOD_TAP_MAX >> 8]                   = DECODE_MOD_TAP,
+};
+
+/* converts key to action */
+action_t action_for_key(uint8_t layer, keypos_t key)
+{
+    // 16bit keycodes - important
+    uint16_t keycode = keymap_key_to_keycode(layer, key);
+
+    // keycode remapping
+    keycode = keycode_config(keycode);
+
+    action_t action;
+    uint8_t action_layer, when, mod;
+    uint8_t decoder = DECODE_NO;
+
+    if (keycode < 0x8000) {
+        decoder = pgm_read_byte(&keycode_decoder_by_high_byte[keycode >> 8]);
+    }
+
+    switch (decoder) {
+        case DECODE_BASIC:
+            action = decode_basic(keycode);
+            break;
+        case DECODE_MODS:
             // Has a modifier
             // Split it up
             action.code = ACTION_MODS_KEY(keycode >> 8, keycode & 0xFF); // adds modifier to key
             break;
-        case QK_FUNCTION ... QK_FUNCTION_MAX: ;
+        case DECODE_FUNCTION:
             // Is a shortcut for function action_layer, pull last 12bits
             // This means we have 4,096 FN macros at our disposal
             action.code = keymap_function_id_to_action( (int)keycode & 0xFFF );
             break;
-        case QK_MACRO ... QK_MACRO_MAX:
+        case DECODE_MACRO:
             if (keycode & 0x800) // tap macros have upper bit set
                 action.code = ACTION_MACRO_TAP(keycode & 0xFF);
             else
                 action.code = ACTION_MACRO(keycode & 0xFF);
             break;
-        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+        case DECODE_LAYER_TAP:
             action.code = ACTION_LAYER_TAP_KEY((keycode >> 0x8) & 0xF, keycode & 0xFF);
             break;
-        case QK_TO ... QK_TO_MAX: ;
+        case DECODE_TO:
             // Layer set "GOTO"
             when = (keycode >> 0x4) & 0x3;
             action_layer = keycode & 0xF;
             action.code = ACTION_LAYER_SET(action_layer, when);
             break;
-        case QK_MOMENTARY ... QK_MOMENTARY_MAX: ;
+        case DECODE_MOMENTARY:
             // Momentary action_layer
             action_layer = keycode & 0xFF;
             action.code = ACTION_LAYER_MOMENTARY(action_layer);
             break;
-        case QK_DEF_LAYER ... QK_DEF_LAYER_MAX: ;
+        case DECODE_DEF_LAYER:
             // Set default action_layer
             action_layer = keycode & 0xFF;
             action.code = ACTION_DEFAULT_LAYER_SET(action_layer);
             break;
-        case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX: ;
+        case DECODE_TOGGLE_LAYER:
             // Set toggle
             action_layer = keycode & 0xFF;
             action.code = ACTION_LAYER_TOGGLE(action_layer);
             break;
-        case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX: ;
+        case DECODE_ONE_SHOT_LAYER:
             // OSL(action_layer) - One-shot action_layer
             action_layer = keycode & 0xFF;
             action.code = ACTION_LAYER_ONESHOT(action_layer);
             break;
-        case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX: ;
+        case DECODE_ONE_SHOT_MOD:
             // OSM(mod) - One-shot mod
             mod = keycode & 0xFF;
             action.code = ACTION_MODS_ONESHOT(mod);
             break;
-        case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:
+        case DECODE_LAYER_TAP_TOGGLE:
             action.code = ACTION_LAYER_TAP_TOGGLE(keycode & 0xFF);
             break;
-        case QK_LAYER_MOD ... QK_LAYER_MOD_MAX:
+        case DECODE_LAYER_MOD:
             mod = keycode & 0xF;
             action_layer = (keycode >> 4) & 0xF;
             action.code = ACTION_LAYER_MODS(action_layer, mod);
             break;
-        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
-            mod = mod_config((keycode >> 0x8) & 0x1F);
-            action.code = ACTION_MODS_TAP_KEY(mod, keycode & 0xFF);
-            break;
-    #ifdef BACKLIGHT_ENABLE
-        case BL_ON:
-            action.code = ACTION_BACKLIGHT_ON();
-            #ifdef SPLIT_KEYBOARD
-                BACKLIT_DIRTY = true;
-            #endif
-            break;
-        case BL_OFF:
-            action.code = ACTION_BACKLIGHT_OFF();
-            #ifdef SPLIT_KEYBOARD
-                BACKLIT_DIRTY = true;
-            #endif
-            break;
-        case BL_DEC:
-            action.code = ACTION_BACKLIGHT_DECREASE();
-            #ifdef SPLIT_KEYBOARD
-                BACKLIT_DIRTY = true;
-            #endif
-            break;
-        case BL_INC:
-            action.code = ACTION_BACKLIGHT_INCREASE();
-            #ifdef SPLIT_KEYBOARD
-                BACKLIT_DIRTY = true;
-            #endif
-            break;
-        case BL_TOGG:
-            action.code = ACTION_BACKLIGHT_TOGGLE();
-            #ifdef SPLIT_KEYBOARD
-                BACKLIT_DIRTY = true;
-            #endif
-            break;
-        case BL_STEP:
-            action.code = ACTION_BACKLIGHT_STEP();
-            #ifdef SPLIT_KEYBOARD
-                BACKLIT_DIRTY = true;
-            #endif
-            break;
-    #endif
     #ifdef SWAP_HANDS_ENABLE
-        case QK_SWAP_HANDS ... QK_SWAP_HANDS_MAX:
+        case DECODE_SWAP_HANDS:
             action.code = ACTION(ACT_SWAP_HANDS, keycode & 0xff);
             break;
     #endif
-
+        case DECODE_QUANTUM:
+            action = decode_quantum(keycode);
+            break;
+        case DECODE_MOD_TAP:
+            mod = mod_config((keycode >> 0x8) & 0x1F);
+            action.code = ACTION_MODS_TAP_KEY(mod, keycode & 0xFF);
+            break;
         default:
             action.code = ACTION_NO;
             break;
@@ -191,6 +270,18 @@ const uint16_t PROGMEM fn_actions[] = {
 
 };
 
+#ifdef TAPPING_POLICY_ENABLE
+/* Without TAPPING_POLICIES() in the keymap every tap key keeps TAPPING_TERM
+ * and the global options. Kept out of action_tapping.c so the compiler can
+ * not fold the weak count into the lookup. */
+__attribute__ ((weak))
+const tapping_policy_t PROGMEM tapping_policies[] = {
+
+};
+__attribute__ ((weak))
+const uint8_t tapping_policies_count = 0;
+#endif
+
 /* Macro */
 __attribute__ ((weak))
 const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt)
@@ -204,10 +295,47 @@ void action_function(keyrecord_t *record, uint8_t id, uint8_t opt)
 {
 }
 
+#ifdef SPARSE_KEYMAP_ENABLE
+/* Keycode of key in a sparse layer, found by binary search of its keys */
+static uint16_t sparse_layer_keycode(const sparse_key_t *keys, uint16_t count, keypos_t key)
+{
+    const sparse_key_index_t index = key.row * MATRIX_COLS + key.col;
+    uint16_t low = 0;
+    uint16_t high = count;
+
+    while (low < high) {
+        const uint16_t middle = low + (high - low) / 2;
+        const sparse_key_index_t middle_key = sizeof(sparse_key_index_t) == 1 ?
+            pgm_read_byte(&keys[middle].key) : pgm_read_word(&keys[middle].key);
+        if (middle_key == index) {
+            return pgm_read_word(&keys[middle].keycode);
+        }
+        if (middle_key < index) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return KC_TRNS;
+}
+#endif
+
 // translates key to keycode
 __attribute__ ((weak))
 uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key)
 {
+#ifdef SPARSE_KEYMAP_ENABLE
+    if (layer < sparse_keymaps_count) {
+    #if defined(__AVR__)
+        const sparse_key_t *keys = (const sparse_key_t *)pgm_read_word(&sparse_keymaps[layer].keys);
+    #else
+        const sparse_key_t *keys = sparse_keymaps[layer].keys;
+    #endif
+        if (keys) {
+            return sparse_layer_keycode(keys, pgm_read_word(&sparse_keymaps[layer].count), key);
+        }
+    }
+#endif
     // Read entire word (16bits)
     return pgm_read_word(&keymaps[(layer)][(key.row)][(key.col)]);
 }
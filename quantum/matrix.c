@@ -25,17 +25,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "matrix.h"
 #include "timer.h"
-
-
-/* Set 0 if debouncing isn't needed */
-
-#ifndef DEBOUNCING_DELAY
-#   define DEBOUNCING_DELAY 5
+#include "debounce.h"
+#if (DIODE_DIRECTION == COL2ROW)
+#include "matrix_col_runs.h"
 #endif
-
-#if (DEBOUNCING_DELAY > 0)
-    static uint16_t debouncing_time;
-    static bool debouncing = false;
+#ifdef MATRIX_SLEEP_ENABLE
+#include "matrix_sleep.h"
 #endif
 
 #if (MATRIX_COLS <= 8)
@@ -65,9 +60,8 @@ static const uint8_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
 #endif
 
 /* matrix state(1:on, 0:off) */
-static matrix_row_t matrix[MATRIX_ROWS];
-
-static matrix_row_t matrix_debouncing[MATRIX_ROWS];
+static matrix_row_t raw_matrix[MATRIX_ROWS]; //raw values
+static matrix_row_t matrix[MATRIX_ROWS]; //debounced values
 
 
 #if (DIODE_DIRECTION == COL2ROW)
@@ -159,60 +153,60 @@ void matrix_init(void) {
 
     // initialize matrix state: all keys off
     for (uint8_t i=0; i < MATRIX_ROWS; i++) {
+        raw_matrix[i] = 0;
         matrix[i] = 0;
-        matrix_debouncing[i] = 0;
     }
 
+    debounce_init(MATRIX_ROWS);
+
+#ifdef MATRIX_SLEEP_ENABLE
+    matrix_sleep_init();
+#endif
+
     matrix_init_quantum();
 }
 
+#ifdef MATRIX_SLEEP_ENABLE
+/* true while any key is down or still bouncing */
+static bool matrix_is_active(void)
+{
+    if (debounce_active()) return true;
+    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+        if (raw_matrix[i] || matrix[i]) return true;
+    }
+    return false;
+}
+#endif
+
 uint8_t matrix_scan(void)
 {
+#ifdef MATRIX_SLEEP_ENABLE
+    // asleep and no pin change since the last call
+    if (!matrix_sleep_scan_begin()) {
+        matrix_scan_quantum();
+        return 0;
+    }
+#endif
 
-#if (DIODE_DIRECTION == COL2ROW)
+    bool changed = false;
 
+#if (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
-#       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_cols_on_row(matrix_debouncing, current_row);
-
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
-
-#       else
-            read_cols_on_row(matrix, current_row);
-#       endif
-
+        changed |= read_cols_on_row(raw_matrix, current_row);
     }
-
 #elif (DIODE_DIRECTION == ROW2COL)
-
     // Set col, read rows
     for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++) {
-#       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_rows_on_col(matrix_debouncing, current_col);
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
-#       else
-             read_rows_on_col(matrix, current_col);
-#       endif
-
+        changed |= read_rows_on_col(raw_matrix, current_col);
     }
-
 #endif
 
-#   if (DEBOUNCING_DELAY > 0)
-        if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
-            for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-                matrix[i] = matrix_debouncing[i];
-            }
-            debouncing = false;
-        }
-#   endif
+    debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
+
+#ifdef MATRIX_SLEEP_ENABLE
+    matrix_sleep_scan_end(matrix_is_active());
+#endif
 
     matrix_scan_quantum();
     return 1;
@@ -220,9 +214,7 @@ uint8_t matrix_scan(void)
 
 bool matrix_is_modified(void)
 {
-#if (DEBOUNCING_DELAY > 0)
-    if (debouncing) return false;
-#endif
+    if (debounce_active()) return false;
     return true;
 }
 
@@ -268,6 +260,8 @@ uint8_t matrix_key_count(void)
 
 #if (DIODE_DIRECTION == COL2ROW)
 
+static col_runs_t col_runs;
+
 static void init_cols(void)
 {
     for(uint8_t x = 0; x < MATRIX_COLS; x++) {
@@ -275,29 +269,42 @@ static void init_cols(void)
         _SFR_IO8((pin >> 4) + 1) &= ~_BV(pin & 0xF); // IN
         _SFR_IO8((pin >> 4) + 2) |=  _BV(pin & 0xF); // HI
     }
+    col_runs_build(&col_runs, col_pins, MATRIX_COLS);
 }
 
 static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
 {
+    uint8_t port_values[MATRIX_COLS];
+
     // Store last value of row prior to reading
     matrix_row_t last_row_value = current_matrix[current_row];
 
-    // Clear data in matrix row
-    current_matrix[current_row] = 0;
-
     // Select row and wait for row selecton to stabilize
     select_row(current_row);
     wait_us(30);
 
-    // For each col...
-    for(uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++) {
+    if (col_runs.per_pin) {
+        // Clear data in matrix row
+        current_matrix[current_row] = 0;
+
+        // For each col...
+        for(uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++) {
 
-        // Select the col pin to read (active low)
-        uint8_t pin = col_pins[col_index];
-        uint8_t pin_state = (_SFR_IO8(pin >> 4) & _BV(pin & 0xF));
+            // Select the col pin to read (active low)
+            uint8_t pin = col_pins[col_index];
+            uint8_t pin_state = (_SFR_IO8(pin >> 4) & _BV(pin & 0xF));
+
+            // Populate the matrix row with the state of the col pin
+            current_matrix[current_row] |=  pin_state ? 0 : (ROW_SHIFTER << col_index);
+        }
+    } else {
+        // Read each port once (cols are active low)
+        for (uint8_t p = 0; p < col_runs.port_count; p++) {
+            port_values[p] = ~_SFR_IO8(col_runs.ports[p]);
+        }
 
-        // Populate the matrix row with the state of the col pin
-        current_matrix[current_row] |=  pin_state ? 0 : (ROW_SHIFTER << col_index);
+        // Populate the matrix row from the port values
+        current_matrix[current_row] = col_runs_gather(&col_runs, port_values);
     }
 
     // Unselect row
@@ -404,3 +411,83 @@ static void unselect_cols(void)
 }
 
 #endif
+
+#if defined(MATRIX_SLEEP_ENABLE) && defined(MATRIX_SLEEP_PCINT0) && defined(__AVR__) && defined(PCMSK0) && \
+    ((DIODE_DIRECTION == COL2ROW) || (DIODE_DIRECTION == ROW2COL))
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/* Pin-change wakeup for matrices whose input pins are all on PORTB, which
+ * maps to PCINT0..7. Only built with MATRIX_SLEEP_PCINT0, as it takes the
+ * PCINT0 vector; other boards provide the matrix_sleep hooks themselves.
+ *
+ * The CPU idles rather than powering down, since the timer tick must keep
+ * running: it still wakes every millisecond for the Timer0 interrupt, so the
+ * saving is the matrix scan and the work of each main loop pass, not the
+ * clock.
+ */
+#if (DIODE_DIRECTION == COL2ROW)
+#   define SLEEP_INPUT_PINS  col_pins
+#   define SLEEP_INPUTS      MATRIX_COLS
+#   define SLEEP_OUTPUTS     MATRIX_ROWS
+#   define sleep_select(x)   select_row(x)
+#   define sleep_unselect()  unselect_rows()
+#else
+#   define SLEEP_INPUT_PINS  row_pins
+#   define SLEEP_INPUTS      MATRIX_ROWS
+#   define SLEEP_OUTPUTS     MATRIX_COLS
+#   define sleep_select(x)   select_col(x)
+#   define sleep_unselect()  unselect_cols()
+#endif
+
+static uint8_t sleep_pcint_mask = 0;
+
+bool matrix_sleep_arm(void)
+{
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < SLEEP_INPUTS; i++) {
+        uint8_t pin = SLEEP_INPUT_PINS[i];
+        if ((pin >> 4) != (B0 >> 4)) return false;
+        mask |= _BV(pin & 0xF);
+    }
+
+    // park every output low so that any press pulls its input low
+    for (uint8_t i = 0; i < SLEEP_OUTPUTS; i++) {
+        sleep_select(i);
+    }
+    wait_us(30);
+
+    sleep_pcint_mask = mask;
+    PCIFR = _BV(PCIF0);
+    PCMSK0 |= mask;
+    PCICR |= _BV(PCIE0);
+
+    // a key that went down before the interrupt was enabled
+    if ((PINB & mask) != mask) {
+        matrix_sleep_wake();
+    }
+    return true;
+}
+
+void matrix_sleep_wait(void)
+{
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+}
+
+void matrix_sleep_disarm(void)
+{
+    PCICR &= ~_BV(PCIE0);
+    PCMSK0 &= ~sleep_pcint_mask;
+    sleep_unselect();
+}
+
+ISR(PCINT0_vect)
+{
+    matrix_sleep_wake();
+}
+
+#endif
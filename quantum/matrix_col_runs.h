@@ -0,0 +1,88 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATRIX_COL_RUNS_H
+#define MATRIX_COL_RUNS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Column pins grouped by port, so a row is read with one read per port.
+ *
+ * Pins are encoded as in MATRIX_COL_PINS: port address in the high nibble,
+ * bit in the low nibble. All the pins of a port whose column is the same
+ * distance from their port bit form one run, and are moved into the row with
+ * a single mask and shift: columns on ascending port bits share a run even
+ * when other pins sit between them. Columns on descending bits cannot share
+ * a shift and cost a run each.
+ *
+ * The tables are built at init, since the preprocessor can not iterate over
+ * the MATRIX_COL_PINS initializer. The build also picks the read once: when
+ * the port reads and runs are no fewer than the columns, as with descending
+ * pins, per_pin is set and the matrix reads one pin at a time instead, so no
+ * layout is slower than before.
+ */
+typedef struct {
+    uint8_t port;   // index into col_runs_t.ports
+    uint8_t mask;   // port bits of the run
+    int8_t shift;   // column minus port bit, the same for every bit of the run
+} col_run_t;
+
+typedef struct {
+    uint8_t ports[MATRIX_COLS];
+    uint8_t port_count;
+    col_run_t runs[MATRIX_COLS];
+    uint8_t run_count;
+    bool per_pin;   // runs save nothing over reading each pin
+} col_runs_t;
+
+static inline void col_runs_build(col_runs_t *t, const uint8_t *pins, uint8_t count)
+{
+    t->port_count = 0;
+    t->run_count = 0;
+    for (uint8_t x = 0; x < count; x++) {
+        uint8_t port = pins[x] >> 4;
+        uint8_t bit = pins[x] & 0xF;
+        int8_t shift = (int8_t)x - (int8_t)bit;
+
+        uint8_t p = 0;
+        while (p < t->port_count && t->ports[p] != port) p++;
+        if (p == t->port_count) t->ports[t->port_count++] = port;
+
+        uint8_t r = 0;
+        while (r < t->run_count && (t->runs[r].port != p || t->runs[r].shift != shift)) r++;
+        if (r == t->run_count) {
+            t->runs[t->run_count++] = (col_run_t){ .port = p, .mask = 0, .shift = shift };
+        }
+        t->runs[r].mask |= 1 << bit;
+    }
+    t->per_pin = t->port_count + t->run_count >= count;
+}
+
+/* port_values[p] holds ports[p] with pressed keys as 1 bits */
+static inline matrix_row_t col_runs_gather(const col_runs_t *t, const uint8_t *port_values)
+{
+    matrix_row_t row = 0;
+    for (uint8_t i = 0; i < t->run_count; i++) {
+        const col_run_t *run = &t->runs[i];
+        matrix_row_t bits = port_values[run->port] & run->mask;
+        row |= run->shift >= 0 ? bits << run->shift : bits >> -run->shift;
+    }
+    return row;
+}
+
+#endif
@@ -0,0 +1,117 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "matrix_sleep.h"
+#include "timer.h"
+
+/* The matrix is either scanning, or asleep with the rows parked and the
+ * input pins armed for a pin-change interrupt. Any edge wakes it for a burst
+ * of full scans that lasts until MATRIX_SLEEP_BURST ms without activity.
+ */
+static volatile bool wake_pending = false;
+static bool asleep = false;
+static bool armed = false;
+static uint16_t last_activity = 0;
+
+/** \brief Arm the wakeup source
+ *
+ * Parks the matrix so that any key press changes an input pin, and enables
+ * the pin-change interrupt that calls matrix_sleep_wake(). Returns false when
+ * the matrix can not be woken by an interrupt; it is then scanned as usual.
+ */
+__attribute__ ((weak))
+bool matrix_sleep_arm(void) {
+    return false;
+}
+
+/** \brief Wait for the next interrupt
+ *
+ * Called while armed. Must return after any interrupt, so that the rest of
+ * the main loop keeps running.
+ */
+__attribute__ ((weak))
+void matrix_sleep_wait(void) {
+}
+
+/** \brief Disarm the wakeup source and restore the matrix for scanning
+ */
+__attribute__ ((weak))
+void matrix_sleep_disarm(void) {
+}
+
+void matrix_sleep_init(void) {
+    wake_pending = false;
+    asleep = false;
+    armed = false;
+    last_activity = timer_read();
+}
+
+/** \brief Called from the pin-change interrupt
+ */
+void matrix_sleep_wake(void) {
+    wake_pending = true;
+}
+
+bool matrix_sleep_is_asleep(void) {
+    return asleep;
+}
+
+static void matrix_sleep_resume(void) {
+    asleep = false;
+    last_activity = timer_read();
+}
+
+/** \brief Start of a matrix scan
+ *
+ * Returns true when the matrix should be read, false when it is asleep and no
+ * edge has arrived since the last call.
+ */
+bool matrix_sleep_scan_begin(void) {
+    if (!asleep) {
+        return true;
+    }
+    if (!armed) {
+        wake_pending = false;
+        if (!matrix_sleep_arm()) {
+            matrix_sleep_resume();
+            return true;
+        }
+        armed = true;
+    }
+    if (!wake_pending) {
+        matrix_sleep_wait();
+        if (!wake_pending) {
+            return false;
+        }
+    }
+    matrix_sleep_disarm();
+    armed = false;
+    matrix_sleep_resume();
+    return true;
+}
+
+/** \brief End of a full matrix scan
+ *
+ * active is true while any key is down or bouncing. A held key keeps the
+ * matrix awake, since a parked row can not see further presses on its column.
+ */
+void matrix_sleep_scan_end(bool active) {
+    if (active) {
+        last_activity = timer_read();
+    } else if (timer_elapsed(last_activity) > MATRIX_SLEEP_BURST) {
+        asleep = true;
+    }
+}
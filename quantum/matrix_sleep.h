@@ -0,0 +1,58 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATRIX_SLEEP_H
+#define MATRIX_SLEEP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* How long (ms) the matrix keeps scanning after the last activity before it
+ * parks the rows and sleeps until a pin-change interrupt. Only the row reads
+ * stop while asleep: matrix_scan_quantum() and the keyboard task's tick
+ * events still run on every pass, and in SLEEP_MODE_IDLE the timer interrupt
+ * wakes the CPU each millisecond, so tapping, one shot and tap dance timeouts
+ * are still serviced. A short burst only means arming and disarming the
+ * wakeup more often.
+ *
+ * The built-in MATRIX_SLEEP_PCINT0 wakeup requires every input pin to be on
+ * PORTB; with any input elsewhere matrix_sleep_arm() refuses and the matrix
+ * never sleeps.
+ */
+#ifndef MATRIX_SLEEP_BURST
+#   define MATRIX_SLEEP_BURST 1000
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void matrix_sleep_init(void);
+bool matrix_sleep_scan_begin(void);
+void matrix_sleep_scan_end(bool active);
+void matrix_sleep_wake(void);
+bool matrix_sleep_is_asleep(void);
+
+/* Hardware hooks, provided by the matrix implementation */
+bool matrix_sleep_arm(void);
+void matrix_sleep_wait(void);
+void matrix_sleep_disarm(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,10 +15,13 @@
  */
 
 #include "process_combo.h"
+#include "action_tapping.h"
 #include "print.h"
+#include <string.h>
 
 
-#define COMBO_TIMER_ELAPSED -1
+/* even, so it never collides with a (odd) timer stamp */
+#define COMBO_TIMER_ELAPSED ((event_time_t)-2)
 
 
 __attribute__ ((weak))
@@ -27,11 +30,11 @@ combo_t key_combos[COMBO_COUNT] = {
 };
 
 __attribute__ ((weak))
-void process_combo_event(uint8_t combo_index, bool pressed) {
+void process_combo_event(combo_id_t combo_index, bool pressed) {
 
 }
 
-static uint8_t current_combo_index = 0;
+static combo_id_t current_combo_index = 0;
 
 static inline void send_combo(uint16_t action, bool pressed)
 {
@@ -46,19 +49,144 @@ static inline void send_combo(uint16_t action, bool pressed)
     }
 }
 
+#ifdef COMBO_INDEX_ENABLE
+/* Keycode to combo index
+ *
+ * Every combo key is listed with the combo it belongs to, sorted by keycode
+ * and then combo, so a key event finds its combos with a binary search and a
+ * key that is in no combo costs one failed search. The index is built in RAM
+ * from key_combos on the first key event, since combos name their keys
+ * through separate arrays that the preprocessor cannot sort. If the combos
+ * have more keys than COMBO_INDEX_SIZE, that is printed to the debug console
+ * and every combo is checked on every key instead.
+ */
+#if COMBO_INDEX_SIZE < COMBO_COUNT * 2
+#error "COMBO_INDEX_SIZE is too small to hold two keys per combo"
+#endif
+
+typedef struct {
+    uint16_t keycode;
+    combo_id_t combo;
+} combo_index_entry_t;
+
+static combo_index_entry_t combo_index[COMBO_INDEX_SIZE];
+static uint16_t combo_index_size = 0;
+static uint8_t combo_length[COMBO_COUNT];
+static enum {
+    COMBO_INDEX_NONE,
+    COMBO_INDEX_BUILT,
+    COMBO_INDEX_FULL,
+} combo_index_state = COMBO_INDEX_NONE;
+
+static void combo_index_build(void)
+{
+    uint16_t combo_keys = 0;
+
+    combo_index_size = 0;
+    combo_index_state = COMBO_INDEX_BUILT;
+    for (combo_id_t c = 0; c < COMBO_COUNT; ++c) {
+        const uint16_t *keys = key_combos[c].keys;
+        uint8_t count = 0;
+        for (uint16_t key; COMBO_END != (key = pgm_read_word(&keys[count])); ++count) {
+            ++combo_keys;
+            if (combo_index_state != COMBO_INDEX_BUILT) continue;
+
+            // insertion sort; a key listed twice in a combo is indexed once
+            uint16_t i = combo_index_size;
+            while (i > 0 && combo_index[i - 1].keycode > key) --i;
+            if (i > 0 && combo_index[i - 1].keycode == key && combo_index[i - 1].combo == c) continue;
+            if (combo_index_size == COMBO_INDEX_SIZE) {
+                combo_index_state = COMBO_INDEX_FULL;
+                continue;
+            }
+            for (uint16_t j = combo_index_size; j > i; --j) {
+                combo_index[j] = combo_index[j - 1];
+            }
+            combo_index[i] = (combo_index_entry_t){ .keycode = key, .combo = c };
+            ++combo_index_size;
+        }
+        combo_length[c] = count;
+    }
+    if (COMBO_INDEX_FULL == combo_index_state) {
+        dprintf("combo: %u combo keys do not fit COMBO_INDEX_SIZE %u, checking every combo\n",
+                combo_keys, COMBO_INDEX_SIZE);
+    }
+}
+
+/* first index entry for keycode, or combo_index_size if there is none */
+static uint16_t combo_index_find(uint16_t keycode)
+{
+    uint16_t low = 0, high = combo_index_size;
+    while (low < high) {
+        uint16_t middle = low + (high - low) / 2;
+        if (combo_index[middle].keycode < keycode) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return (low < combo_index_size && combo_index[low].keycode == keycode) ? low : combo_index_size;
+}
+
+/** \brief Combo index is full
+ *
+ * Returns true when the combos did not fit COMBO_INDEX_SIZE, so every combo
+ * is checked on every key.
+ */
+bool combo_index_is_full(void)
+{
+    if (COMBO_INDEX_NONE == combo_index_state) {
+        combo_index_build();
+    }
+    return COMBO_INDEX_FULL == combo_index_state;
+}
+#else
+static uint8_t combo_key_count(const combo_t *combo)
+{
+    uint8_t count = 0;
+    while (COMBO_END != pgm_read_word(&combo->keys[count])) ++count;
+    return count;
+}
+#endif
+
+/* Combos in progress
+ *
+ * A combo is in progress while its timer holds a (odd) stamp. Those combos
+ * are flagged in combo_pending, and combo_oldest is no later than the oldest
+ * of their stamps, so matrix_scan_combo() only looks at the combos once that
+ * one may have timed out.
+ */
+static uint8_t combo_pending[(COMBO_COUNT + 7) / 8];
+static combo_id_t combo_pending_count = 0;
+static event_time_t combo_oldest;
+
+#define COMBO_IS_PENDING(combo)     ((combo)->timer & 1)
+#define COMBO_PENDING_BIT(id)       ((uint8_t)1 << ((id) & 7))
+
+static void combo_update_pending(combo_id_t id, const combo_t *combo)
+{
+    bool was_pending = combo_pending[id / 8] & COMBO_PENDING_BIT(id);
+    if (COMBO_IS_PENDING(combo)) {
+        if (was_pending) return;
+        if (!combo_pending_count) combo_oldest = combo->timer;
+        combo_pending[id / 8] |= COMBO_PENDING_BIT(id);
+        ++combo_pending_count;
+    } else if (was_pending) {
+        combo_pending[id / 8] &= ~COMBO_PENDING_BIT(id);
+        --combo_pending_count;
+    }
+}
+
 #define ALL_COMBO_KEYS_ARE_DOWN     (((1<<count)-1) == combo->state)
 #define NO_COMBO_KEYS_ARE_DOWN      (0 == combo->state)
 #define KEY_STATE_DOWN(key)         do{ combo->state |= (1<<key); } while(0)
 #define KEY_STATE_UP(key)           do{ combo->state &= ~(1<<key); } while(0)
-static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record) 
+static bool process_single_combo(combo_t *combo, uint8_t count, uint16_t keycode, keyrecord_t *record) 
 {
-    uint8_t count = 0;
     uint8_t index = -1;
-    /* Find index of keycode and number of combo keys */
-    for (const uint16_t *keys = combo->keys; ;++count) {
-        uint16_t key = pgm_read_word(&keys[count]);
-        if (keycode == key) index = count;
-        if (COMBO_END == key) break;
+    /* Find index of keycode */
+    for (uint8_t i = 0; i < count; ++i) {
+        if (keycode == pgm_read_word(&combo->keys[i])) index = i;
     }
 
     /* Return if not a combo key */
@@ -75,7 +203,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
                 send_combo(combo->keycode, true);
                 combo->timer = COMBO_TIMER_ELAPSED;
             } else { /* Combo key was pressed */
-                combo->timer = timer_read();
+                combo->timer = event_timer_stamp();
 #ifdef COMBO_ALLOW_ACTION_KEYS
                 combo->prev_record = *record;
 #else
@@ -96,7 +224,6 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
             process_action(record, store_or_get_action(record->event.pressed, record->event.key));
 #else
             register_code16(keycode);
-            send_keyboard_report();
             unregister_code16(keycode);
 #endif
             combo->timer = 0;            
@@ -116,30 +243,85 @@ bool process_combo(uint16_t keycode, keyrecord_t *record)
 {
     bool is_combo_key = false;
 
+#ifdef COMBO_INDEX_ENABLE
+    if (COMBO_INDEX_NONE == combo_index_state) {
+        combo_index_build();
+    }
+
+    if (COMBO_INDEX_BUILT == combo_index_state) {
+        for (uint16_t i = combo_index_find(keycode); i < combo_index_size && combo_index[i].keycode == keycode; ++i) {
+            current_combo_index = combo_index[i].combo;
+            combo_t *combo = &key_combos[current_combo_index];
+            is_combo_key |= process_single_combo(combo, combo_length[current_combo_index], keycode, record);
+            combo_update_pending(current_combo_index, combo);
+        }
+        return !is_combo_key;
+    }
+#endif
+
     for (current_combo_index = 0; current_combo_index < COMBO_COUNT; ++current_combo_index) {
         combo_t *combo = &key_combos[current_combo_index];
-        is_combo_key |= process_single_combo(combo, keycode, record);
-    }    
+#ifdef COMBO_INDEX_ENABLE
+        uint8_t count = combo_length[current_combo_index];
+#else
+        uint8_t count = combo_key_count(combo);
+#endif
+        is_combo_key |= process_single_combo(combo, count, keycode, record);
+        combo_update_pending(current_combo_index, combo);
+    }
 
     return !is_combo_key;
 }
 
+/** \brief Rebuild the combo index
+ *
+ * Call after changing key_combos at run time. Combos in progress are
+ * forgotten, so their keys no longer time out.
+ */
+void combo_index_invalidate(void)
+{
+#ifdef COMBO_INDEX_ENABLE
+    combo_index_state = COMBO_INDEX_NONE;
+#endif
+    memset(combo_pending, 0, sizeof(combo_pending));
+    combo_pending_count = 0;
+}
+
+/** \brief Combo timeout
+ *
+ * Sends the held key of each combo that was not completed within COMBO_TERM.
+ * While no combo is in progress, or the oldest one has not timed out, this
+ * is a single comparison.
+ */
 void matrix_scan_combo(void)
 {
-    for (int i = 0; i < COMBO_COUNT; ++i) {
-        // Do not treat the (weak) key_combos too strict.
-        #pragma GCC diagnostic push
-        #pragma GCC diagnostic ignored "-Warray-bounds"
-        combo_t *combo = &key_combos[i];
-        #pragma GCC diagnostic pop
-        if (combo->timer &&
-            combo->timer != COMBO_TIMER_ELAPSED && 
-            timer_elapsed(combo->timer) > COMBO_TERM) {
-            
+    if (!combo_pending_count || event_timer_elapsed(combo_oldest) <= COMBO_TERM) return;
+
+    event_time_t oldest_elapsed = 0;
+    for (uint16_t byte = 0; byte < sizeof(combo_pending); ++byte) {
+        uint8_t pending = combo_pending[byte];
+        for (combo_id_t i = byte * 8; pending; ++i, pending >>= 1) {
+            if (!(pending & 1)) continue;
+
+            // Do not treat the (weak) key_combos too strict.
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Warray-bounds"
+            combo_t *combo = &key_combos[i];
+            #pragma GCC diagnostic pop
+            event_time_t elapsed = event_timer_elapsed(combo->timer);
+            if (elapsed <= COMBO_TERM) {
+                if (elapsed >= oldest_elapsed) {
+                    oldest_elapsed = elapsed;
+                    combo_oldest = combo->timer;
+                }
+                continue;
+            }
+
             /* This disables the combo, meaning key events for this
              * combo will be handled by the next processors in the chain 
              */
             combo->timer = COMBO_TIMER_ELAPSED;
+            combo_update_pending(i, combo);
 
 #ifdef COMBO_ALLOW_ACTION_KEYS
             process_action(&combo->prev_record, 
@@ -32,7 +32,7 @@ typedef struct
 #else
     uint8_t state;
 #endif
-    uint16_t timer;
+    event_time_t timer;
 #ifdef COMBO_ALLOW_ACTION_KEYS
     keyrecord_t prev_record;
 #else
@@ -51,9 +51,23 @@ typedef struct
 #ifndef COMBO_TERM
 #define COMBO_TERM TAPPING_TERM
 #endif
+/* how many combo keys, over all combos, the keycode index can hold */
+#if defined(COMBO_INDEX_ENABLE) && !defined(COMBO_INDEX_SIZE)
+#define COMBO_INDEX_SIZE (COMBO_COUNT * 3)
+#endif
+
+#if COMBO_COUNT > 255
+typedef uint16_t combo_id_t;
+#else
+typedef uint8_t combo_id_t;
+#endif
 
 bool process_combo(uint16_t keycode, keyrecord_t *record);
 void matrix_scan_combo(void);
-void process_combo_event(uint8_t combo_index, bool pressed);
+void process_combo_event(combo_id_t combo_index, bool pressed);
+void combo_index_invalidate(void);
+#ifdef COMBO_INDEX_ENABLE
+bool combo_index_is_full(void);
+#endif
 
 #endif
@@ -0,0 +1,280 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "process_positional_combo.h"
+#include "matrix.h"
+#include "action.h"
+#include "quantum.h"
+
+/* Every mask is a matrix bitmap, one matrix_row_t per row, so testing
+ * whether a combo contains a key is a single bit test.
+ */
+typedef matrix_row_t combo_mask_t[MATRIX_ROWS];
+
+static combo_mask_t combo_masks[POSITIONAL_COMBO_COUNT];
+static uint8_t combo_sizes[POSITIONAL_COMBO_COUNT];
+static combo_mask_t any_combo_keys;     // keys that are in some combo
+static combo_mask_t held_keys;          // pressed keys held back
+static combo_mask_t fired_keys;         // keys of fired combos still down
+static bool combo_fired[POSITIONAL_COMBO_COUNT];
+static bool masks_built = false;
+
+/* combos that have not fired and contain every held key */
+static uint8_t candidates[(POSITIONAL_COMBO_COUNT + 7) / 8];
+
+static keyevent_t held_events[POSITIONAL_COMBO_MAX_KEYS];
+static uint8_t held_count = 0;
+
+/* Events waiting for positional_combo_task()
+ *
+ * Held back keys are not replayed from inside action_exec(), which would
+ * nest it. They go to replay_events, which positional_combo_task() passes
+ * to action_exec() from the keyboard task without matching them again.
+ * Events that arrive while replays are waiting must not overtake them, so
+ * they wait in the deferred ring and are matched once the replays are done.
+ */
+static keyevent_t replay_events[POSITIONAL_COMBO_MAX_KEYS + 1];
+static uint8_t replay_count = 0;
+static keyevent_t deferred_events[POSITIONAL_COMBO_DEFERRED_SIZE];
+static uint8_t deferred_head = 0;
+static uint8_t deferred_tail = 0;
+static bool replaying = false;
+static bool draining = false;
+
+__attribute__ ((weak))
+void process_positional_combo_event(uint8_t combo_index, bool pressed) {
+}
+
+#define KEY_BIT(key)    ((matrix_row_t)1 << (key).col)
+
+static void build_masks(void)
+{
+    for (uint8_t c = 0; c < POSITIONAL_COMBO_COUNT; c++) {
+#if defined(__AVR__)
+        const keypos_t *keys = (const keypos_t *)pgm_read_word(&positional_combos[c].keys);
+#else
+        const keypos_t *keys = positional_combos[c].keys;
+#endif
+        for (uint8_t i = 0; ; i++) {
+            keypos_t key = {
+                .col = pgm_read_byte(&keys[i].col),
+                .row = pgm_read_byte(&keys[i].row)
+            };
+            if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) break;
+            if (!(combo_masks[c][key.row] & KEY_BIT(key))) combo_sizes[c]++;
+            combo_masks[c][key.row] |= KEY_BIT(key);
+            any_combo_keys[key.row] |= KEY_BIT(key);
+        }
+    }
+    masks_built = true;
+}
+
+static void send_combo(uint8_t index, bool pressed)
+{
+    uint16_t keycode = pgm_read_word(&positional_combos[index].keycode);
+    if (!keycode) {
+        process_positional_combo_event(index, pressed);
+    } else if (pressed) {
+        register_code16(keycode);
+    } else {
+        unregister_code16(keycode);
+    }
+}
+
+/* queues the held back presses for replay, oldest first */
+static void release_held_keys(void)
+{
+    for (uint8_t i = 0; i < held_count; i++) {
+        replay_events[replay_count++] = held_events[i];
+    }
+    held_count = 0;
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        held_keys[r] = 0;
+    }
+}
+
+/* queues event to pass on after the held back presses */
+static void release_held_keys_then(keyevent_t event)
+{
+    release_held_keys();
+    replay_events[replay_count++] = event;
+}
+
+typedef enum {
+    HELD_KEYS_NO_COMBO,     // the held keys cannot grow into a combo
+    HELD_KEYS_PARTIAL,      // the held keys may still grow into a combo
+    HELD_KEYS_COMBO,        // the held keys are exactly a combo
+} held_keys_match_t;
+
+#define CANDIDATE_BIT(c)    ((uint8_t)1 << ((c) & 7))
+
+/* Narrows the candidates to the combos that contain key, which was just
+ * added to the held keys. On HELD_KEYS_COMBO, *combo is the first combo made
+ * of exactly the held keys.
+ *
+ * The first held key tests one bit per combo; every later key only visits
+ * the combos still in the running, a bit test each.
+ */
+static held_keys_match_t match_held_keys(keypos_t key, uint8_t *combo)
+{
+    bool partial = false;
+    for (uint8_t byte = 0; byte < sizeof(candidates); byte++) {
+        if (held_count == 1) {
+            candidates[byte] = 0xFF;
+        }
+        uint8_t running = candidates[byte];
+        for (uint8_t c = byte * 8; running && c < POSITIONAL_COMBO_COUNT; c++, running >>= 1) {
+            if (!(running & 1)) continue;
+            if (combo_fired[c] || !(combo_masks[c][key.row] & KEY_BIT(key))) {
+                candidates[byte] &= ~CANDIDATE_BIT(c);
+                continue;
+            }
+            if (combo_sizes[c] == held_count) {
+                *combo = c;
+                return HELD_KEYS_COMBO;
+            }
+            partial = true;
+        }
+    }
+    return partial ? HELD_KEYS_PARTIAL : HELD_KEYS_NO_COMBO;
+}
+
+static bool process_press(keyevent_t event)
+{
+    keypos_t key = event.key;
+    if (!(any_combo_keys[key.row] & KEY_BIT(key))) {
+        if (!held_count) return true;
+        release_held_keys_then(event);
+        return false;
+    }
+
+    if (held_count == POSITIONAL_COMBO_MAX_KEYS) {
+        release_held_keys();
+    }
+    held_keys[key.row] |= KEY_BIT(key);
+    held_events[held_count++] = event;
+
+    uint8_t combo;
+    held_keys_match_t match = match_held_keys(key, &combo);
+    if (HELD_KEYS_NO_COMBO == match && held_count > 1) {
+        // the earlier keys cannot combine with this one; it may start anew
+        held_keys[key.row] &= ~KEY_BIT(key);
+        held_count--;
+        release_held_keys();
+        held_keys[key.row] |= KEY_BIT(key);
+        held_events[held_count++] = event;
+        match = match_held_keys(key, &combo);
+    }
+    if (HELD_KEYS_NO_COMBO == match) {
+        held_keys[key.row] &= ~KEY_BIT(key);
+        held_count = 0;
+        if (!replay_count) return true;
+        replay_events[replay_count++] = event;
+        return false;
+    }
+    if (HELD_KEYS_COMBO == match) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            fired_keys[r] |= held_keys[r];
+            held_keys[r] = 0;
+        }
+        held_count = 0;
+        combo_fired[combo] = true;
+        send_combo(combo, true);
+    }
+    return false;
+}
+
+static bool process_release(keyevent_t event)
+{
+    keypos_t key = event.key;
+    if (fired_keys[key.row] & KEY_BIT(key)) {
+        // the first key released ends the combo, the others are swallowed
+        fired_keys[key.row] &= ~KEY_BIT(key);
+        for (uint8_t c = 0; c < POSITIONAL_COMBO_COUNT; c++) {
+            if (combo_fired[c] && (combo_masks[c][key.row] & KEY_BIT(key))) {
+                combo_fired[c] = false;
+                send_combo(c, false);
+            }
+        }
+        return false;
+    }
+    if (held_keys[key.row] & KEY_BIT(key)) {
+        release_held_keys_then(event);
+        return false;
+    }
+    return true;
+}
+
+/** \brief Process positional combo
+ *
+ * Called by action_exec() with every key event, before layers are looked
+ * at. Returns false when the event is held back, waits behind replayed
+ * keys or belongs to a fired combo.
+ */
+bool process_positional_combo(keyevent_t event)
+{
+    if (replaying || IS_NOEVENT(event)) return true;
+    if (!masks_built) build_masks();
+    if (event.key.row >= MATRIX_ROWS || event.key.col >= MATRIX_COLS) return true;
+
+    if (!draining && (replay_count || deferred_head != deferred_tail)) {
+        if ((uint8_t)(deferred_tail - deferred_head) == POSITIONAL_COMBO_DEFERRED_SIZE) {
+            dprint("positional combo: deferred events full\n");
+            return true;
+        }
+        deferred_events[deferred_tail++ & (POSITIONAL_COMBO_DEFERRED_SIZE - 1)] = event;
+        return false;
+    }
+    return event.pressed ? process_press(event) : process_release(event);
+}
+
+/** \brief Positional combo task
+ *
+ * Called by keyboard_task() after the key events of the scan. Passes the
+ * replayed keys to action_exec(), then matches the events that waited
+ * behind them, which may queue more replays.
+ */
+void positional_combo_task(void)
+{
+    draining = true;
+    while (true) {
+        if (replay_count) {
+            replaying = true;
+            for (uint8_t i = 0; i < replay_count; i++) {
+                action_exec(replay_events[i]);
+            }
+            replay_count = 0;
+            replaying = false;
+        } else if (deferred_head != deferred_tail) {
+            action_exec(deferred_events[deferred_head++ & (POSITIONAL_COMBO_DEFERRED_SIZE - 1)]);
+        } else {
+            break;
+        }
+    }
+    draining = false;
+}
+
+/** \brief Positional combo timeout
+ *
+ * Queues the held back keys for replay once the first of them has been held
+ * for COMBO_TERM without completing a combo.
+ */
+void matrix_scan_positional_combo(void)
+{
+    if (held_count && TIMER_DIFF_EVENT(event_timer_read(), held_events[0].time) > COMBO_TERM) {
+        release_held_keys();
+    }
+}
@@ -0,0 +1,75 @@
+/* Copyright 2017 QMK contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROCESS_POSITIONAL_COMBO_H
+#define PROCESS_POSITIONAL_COMBO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "progmem.h"
+#include "keyboard.h"
+#include "action.h"
+
+/* Combos keyed on matrix positions
+ *
+ * A positional combo fires when all of its keys are down, whatever layer is
+ * on, before the keys are resolved to keycodes. Keys that may start a combo
+ * are held back until the combo fires, a key outside it is pressed, one of
+ * them is released or COMBO_TERM passes; then positional_combo_task()
+ * replays them in order from the keyboard task.
+ *
+ * positional_combos[] and the key lists it points to live in PROGMEM.
+ */
+typedef struct {
+    const keypos_t *keys;   // PROGMEM, ends with COMBO_POS_END
+    uint16_t keycode;       // sent while the combo is held, 0 for an event
+} positional_combo_t;
+
+#define COMBO_POS(r, c)             { .col = (c), .row = (r) }
+#define COMBO_POS_END               { .col = 255, .row = 255 }
+#define POSITIONAL_COMBO(ck, ca)    { .keys = &(ck)[0], .keycode = (ca) }
+#define POSITIONAL_COMBO_ACTION(ck) { .keys = &(ck)[0], .keycode = 0 }
+
+#ifndef POSITIONAL_COMBO_COUNT
+#define POSITIONAL_COMBO_COUNT 0
+#endif
+#if POSITIONAL_COMBO_COUNT > 255
+#error "POSITIONAL_COMBO_COUNT must fit the uint8_t combo index"
+#endif
+#ifndef COMBO_TERM
+#define COMBO_TERM TAPPING_TERM
+#endif
+/* most keys held back at once, at least the size of the largest combo */
+#ifndef POSITIONAL_COMBO_MAX_KEYS
+#define POSITIONAL_COMBO_MAX_KEYS 4
+#endif
+/* most key events that can wait behind replayed keys, a power of two */
+#ifndef POSITIONAL_COMBO_DEFERRED_SIZE
+#define POSITIONAL_COMBO_DEFERRED_SIZE 4
+#endif
+#if (POSITIONAL_COMBO_DEFERRED_SIZE & (POSITIONAL_COMBO_DEFERRED_SIZE - 1)) || POSITIONAL_COMBO_DEFERRED_SIZE > 128
+#error "POSITIONAL_COMBO_DEFERRED_SIZE must be a power of two no larger than 128"
+#endif
+
+extern const positional_combo_t PROGMEM positional_combos[];
+
+/* false when the event is held back or consumed by a combo */
+bool process_positional_combo(keyevent_t event);
+void matrix_scan_positional_combo(void);
+void positional_combo_task(void);
+void process_positional_combo_event(uint8_t combo_index, bool pressed);
+
+#endif
@@ -98,18 +98,22 @@ static inline void process_tap_dance_action_on_dance_finished (qk_tap_dance_acti
   if (action->state.finished)
     return;
   action->state.finished = true;
-  add_mods(action->state.oneshot_mods);
-  add_weak_mods(action->state.weak_mods);
-  send_keyboard_report();
+  if (action->state.oneshot_mods || action->state.weak_mods) {
+    add_mods(action->state.oneshot_mods);
+    add_weak_mods(action->state.weak_mods);
+    send_keyboard_report();
+  }
   _process_tap_dance_action_fn (&action->state, action->user_data, action->fn.on_dance_finished);
 }
 
 static inline void process_tap_dance_action_on_reset (qk_tap_dance_action_t *action)
 {
   _process_tap_dance_action_fn (&action->state, action->user_data, action->fn.on_reset);
-  del_mods(action->state.oneshot_mods);
-  del_weak_mods(action->state.weak_mods);
-  send_keyboard_report();
+  if (action->state.oneshot_mods || action->state.weak_mods) {
+    del_mods(action->state.oneshot_mods);
+    del_weak_mods(action->state.weak_mods);
+    send_keyboard_report();
+  }
 }
 
 void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
@@ -147,7 +151,7 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     if (record->event.pressed) {
       action->state.keycode = keycode;
       action->state.count++;
-      action->state.timer = timer_read();
+      action->state.timer = event_timer_read();
 #ifndef NO_ACTION_ONESHOT
       action->state.oneshot_mods = get_oneshot_mods();
 #else
@@ -185,7 +189,7 @@ void matrix_scan_tap_dance () {
     else{
       tap_user_defined = TAPPING_TERM;
     }
-    if (action->state.count && timer_elapsed (action->state.timer) > tap_user_defined) {
+    if (action->state.count && event_timer_elapsed(action->state.timer) > tap_user_defined) {
       process_tap_dance_action_on_dance_finished (action);
       reset_tap_dance (&action->state);
     }
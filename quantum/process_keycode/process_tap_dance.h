@@ -20,6 +20,7 @@
 
 #include <stdbool.h>
 #include <inttypes.h>
+#include "timer.h"
 
 typedef struct
 {
@@ -27,7 +28,7 @@ typedef struct
   uint8_t oneshot_mods;
   uint8_t weak_mods;
   uint16_t keycode;
-  uint16_t timer;
+  event_time_t timer;
   bool interrupted;
   bool pressed;
   bool finished;
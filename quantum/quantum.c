@@ -30,6 +30,8 @@
 #include "backlight.h"
 extern backlight_config_t backlight_config;
 
+#include "profile.h"
+
 #ifdef FAUXCLICKY_ENABLE
 #include "fauxclicky.h"
 #endif
@@ -190,6 +192,88 @@ static uint16_t scs_timer[2] = {0, 0};
  */
 static bool grave_esc_was_shifted = false;
 
+/* A record processor declares the keycodes it acts on; the key only reaches
+ * it when its keycode is in first...last. Processors that react to any key
+ * (modes that capture typing, or state that other keys finish) observe with
+ * PROCESS_ALL_KEYS. Either stops the chain when the processor returns false,
+ * and times it as PROFILE_PROCESS_<stage> when PROFILE_PROCESSORS is on.
+ */
+#define PROCESS_KEYS(stage, processor, first, last) \
+  if (keycode >= (first) && keycode <= (last) && !PROCESS_CALL(stage, processor)) return false
+#define PROCESS_ALL_KEYS(stage, processor) \
+  if (!PROCESS_CALL(stage, processor)) return false
+
+#ifdef PROFILE_PROCESSORS
+static inline bool process_profiled(profile_stage_t stage, bool (*processor)(uint16_t, keyrecord_t *), uint16_t keycode, keyrecord_t *record) {
+  profile_start(stage);
+  bool result = processor(keycode, record);
+  profile_stop(stage);
+  return result;
+}
+#define PROCESS_CALL(stage, processor)  process_profiled(PROFILE_PROCESS_##stage, processor, keycode, record)
+#else
+#define PROCESS_CALL(stage, processor)  processor(keycode, record)
+#endif
+
+/** \brief Run the record processors
+ *
+ * Calls the processors registered for keycode, in order, and returns false as
+ * soon as one of them does.
+ */
+bool process_record_processors(uint16_t keycode, keyrecord_t *record) {
+  #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
+    PROCESS_ALL_KEYS(CLICKY, process_clicky);
+  #endif //AUDIO_CLICKY
+    PROCESS_ALL_KEYS(RECORD_KB, process_record_kb);
+  #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_KEYPRESSES)
+    PROCESS_ALL_KEYS(RGB_MATRIX, process_rgb_matrix);
+  #endif
+  #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
+    PROCESS_KEYS(MIDI, process_midi, MIDI_TONE_MIN, MI_BENDU);
+  #endif
+  #ifdef AUDIO_ENABLE
+    PROCESS_KEYS(AUDIO, process_audio, AU_ON, MUV_DE);
+  #endif
+  #ifdef STENO_ENABLE
+    PROCESS_KEYS(STENO, process_steno, QK_STENO, QK_STENO_MAX);
+  #endif
+  #if ( defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
+    PROCESS_ALL_KEYS(MUSIC, process_music);
+  #endif
+  #ifdef TAP_DANCE_ENABLE
+    // other keys interrupt a dance in preprocess_tap_dance()
+    PROCESS_KEYS(TAP_DANCE, process_tap_dance, QK_TAP_DANCE, QK_TAP_DANCE_MAX);
+  #endif
+  #ifndef DISABLE_LEADER
+    PROCESS_ALL_KEYS(LEADER, process_leader);
+  #endif
+  #ifndef DISABLE_CHORDING
+    PROCESS_KEYS(CHORDING, process_chording, QK_CHORDING, QK_CHORDING_MAX);
+  #endif
+  #ifdef COMBO_ENABLE
+    PROCESS_ALL_KEYS(COMBO, process_combo);
+  #endif
+  #ifdef UNICODE_ENABLE
+    PROCESS_KEYS(UNICODE, process_unicode, QK_UNICODE, QK_UNICODE_MAX);
+  #endif
+  #ifdef UCIS_ENABLE
+    PROCESS_ALL_KEYS(UCIS, process_ucis);
+  #endif
+  #ifdef PRINTING_ENABLE
+    PROCESS_ALL_KEYS(PRINTER, process_printer);
+  #endif
+  #ifdef AUTO_SHIFT_ENABLE
+    PROCESS_ALL_KEYS(AUTO_SHIFT, process_auto_shift);
+  #endif
+  #ifdef UNICODEMAP_ENABLE
+    PROCESS_KEYS(UNICODE_MAP, process_unicode_map, QK_UNICODE_MAP, QK_UNICODE_MAX);
+  #endif
+  #ifdef TERMINAL_ENABLE
+    PROCESS_ALL_KEYS(TERMINAL, process_terminal);
+  #endif
+    return true;
+}
+
 bool process_record_quantum(keyrecord_t *record) {
 
   /* This gets the keycode from the key pressed */
@@ -224,61 +308,17 @@ bool process_record_quantum(keyrecord_t *record) {
     preprocess_tap_dance(keycode, record);
   #endif
 
-  if (!(
   #if defined(KEY_LOCK_ENABLE)
     // Must run first to be able to mask key_up events.
-    process_key_lock(&keycode, record) &&
-  #endif
-  #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-      process_clicky(keycode, record) &&
-  #endif //AUDIO_CLICKY
-    process_record_kb(keycode, record) &&
-  #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_KEYPRESSES)
-    process_rgb_matrix(keycode, record) &&
-  #endif
-  #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-    process_midi(keycode, record) &&
-  #endif
-  #ifdef AUDIO_ENABLE
-    process_audio(keycode, record) &&
-  #endif
-  #ifdef STENO_ENABLE
-    process_steno(keycode, record) &&
-  #endif
-  #if ( defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-    process_music(keycode, record) &&
-  #endif
-  #ifdef TAP_DANCE_ENABLE
-    process_tap_dance(keycode, record) &&
-  #endif
-  #ifndef DISABLE_LEADER
-    process_leader(keycode, record) &&
-  #endif
-  #ifndef DISABLE_CHORDING
-    process_chording(keycode, record) &&
-  #endif
-  #ifdef COMBO_ENABLE
-    process_combo(keycode, record) &&
-  #endif
-  #ifdef UNICODE_ENABLE
-    process_unicode(keycode, record) &&
-  #endif
-  #ifdef UCIS_ENABLE
-    process_ucis(keycode, record) &&
-  #endif
-  #ifdef PRINTING_ENABLE
-    process_printer(keycode, record) &&
-  #endif
-  #ifdef AUTO_SHIFT_ENABLE
-    process_auto_shift(keycode, record) &&
-  #endif
-  #ifdef UNICODEMAP_ENABLE
-    process_unicode_map(keycode, record) &&
-  #endif
-  #ifdef TERMINAL_ENABLE
-    process_terminal(keycode, record) &&
+    PROFILE_PROCESS_START(KEY_LOCK);
+    bool unlocked = process_key_lock(&keycode, record);
+    PROFILE_PROCESS_STOP(KEY_LOCK);
+    if (!unlocked) {
+      return false;
+    }
   #endif
-      true)) {
+
+  if (!process_record_processors(keycode, record)) {
     return false;
   }
 
@@ -866,9 +906,9 @@ void set_single_persistent_default_layer(uint8_t default_layer) {
   default_layer_set(1U<<default_layer);
 }
 
-uint32_t update_tri_layer_state(uint32_t state, uint8_t layer1, uint8_t layer2, uint8_t layer3) {
-  uint32_t mask12 = (1UL << layer1) | (1UL << layer2);
-  uint32_t mask3 = 1UL << layer3;
+layer_state_t update_tri_layer_state(layer_state_t state, uint8_t layer1, uint8_t layer2, uint8_t layer3) {
+  layer_state_t mask12 = ((layer_state_t)1 << layer1) | ((layer_state_t)1 << layer2);
+  layer_state_t mask3 = (layer_state_t)1 << layer3;
   return (state & mask12) == mask12 ? (state | mask3) : (state & ~mask3);
 }
 
@@ -935,30 +975,46 @@ uint8_t rgb_matrix_task_counter = 0;
 
 void matrix_scan_quantum() {
   #if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
+    PROFILE_START(MUSIC);
     matrix_scan_music();
+    PROFILE_STOP(MUSIC);
   #endif
 
   #ifdef TAP_DANCE_ENABLE
+    PROFILE_START(TAP_DANCE);
     matrix_scan_tap_dance();
+    PROFILE_STOP(TAP_DANCE);
   #endif
 
   #ifdef COMBO_ENABLE
+    PROFILE_START(COMBO);
     matrix_scan_combo();
+    PROFILE_STOP(COMBO);
+  #endif
+
+  #ifdef POSITIONAL_COMBO_ENABLE
+    matrix_scan_positional_combo();
   #endif
 
   #if defined(BACKLIGHT_ENABLE) && defined(BACKLIGHT_PIN)
+    PROFILE_START(BACKLIGHT);
     backlight_task();
+    PROFILE_STOP(BACKLIGHT);
   #endif
 
   #ifdef RGB_MATRIX_ENABLE
+    PROFILE_START(RGB_MATRIX);
     rgb_matrix_task();
     if (rgb_matrix_task_counter == 0) {
       rgb_matrix_update_pwm_buffers();
     }
     rgb_matrix_task_counter = ((rgb_matrix_task_counter + 1) % (RGB_MATRIX_SKIP_FRAMES + 1));
+    PROFILE_STOP(RGB_MATRIX);
   #endif
 
+  PROFILE_START(MATRIX_SCAN_KB);
   matrix_scan_kb();
+  PROFILE_STOP(MATRIX_SCAN_KB);
 }
 #if defined(BACKLIGHT_ENABLE) && defined(BACKLIGHT_PIN)
 
@@ -43,6 +43,7 @@
 #endif
 
 #include "action_layer.h"
+#include "action_tapping.h"
 #include "eeconfig.h"
 #include <stddef.h>
 #include "bootloader.h"
@@ -55,10 +56,10 @@
 #include "send_string_keycodes.h"
 #include "suspend.h"
 
-extern uint32_t default_layer_state;
+extern layer_state_t default_layer_state;
 
 #ifndef NO_ACTION_LAYER
-    extern uint32_t layer_state;
+    extern layer_state_t layer_state;
 #endif
 
 #ifdef MIDI_ENABLE
@@ -118,6 +119,10 @@ extern uint32_t default_layer_state;
     #include "process_combo.h"
 #endif
 
+#ifdef POSITIONAL_COMBO_ENABLE
+    #include "process_positional_combo.h"
+#endif
+
 #ifdef KEY_LOCK_ENABLE
     #include "process_key_lock.h"
 #endif
@@ -159,14 +164,14 @@ void send_char(char ascii_code);
 
 // For tri-layer
 void update_tri_layer(uint8_t layer1, uint8_t layer2, uint8_t layer3);
-uint32_t update_tri_layer_state(uint32_t state, uint8_t layer1, uint8_t layer2, uint8_t layer3);
+layer_state_t update_tri_layer_state(layer_state_t state, uint8_t layer1, uint8_t layer2, uint8_t layer3);
 
 void set_single_persistent_default_layer(uint8_t default_layer);
 
 void tap_random_base64(void);
 
-#define IS_LAYER_ON(layer)  (layer_state & (1UL << (layer)))
-#define IS_LAYER_OFF(layer) (~layer_state & (1UL << (layer)))
+#define IS_LAYER_ON(layer)  (layer_state & ((layer_state_t)1 << (layer)))
+#define IS_LAYER_OFF(layer) (~layer_state & ((layer_state_t)1 << (layer)))
 
 void matrix_init_kb(void);
 void matrix_scan_kb(void);
@@ -176,6 +181,8 @@ bool process_action_kb(keyrecord_t *record);
 bool process_record_kb(uint16_t keycode, keyrecord_t *record);
 bool process_record_user(uint16_t keycode, keyrecord_t *record);
 
+bool process_record_processors(uint16_t keycode, keyrecord_t *record);
+
 void reset_keyboard(void);
 
 void startup_user(void);
@@ -2,6 +2,8 @@
 #define I2C_H
 
 #include <stdint.h>
+#include "matrix.h"
+#include "split_rows.h"
 
 #ifndef F_CPU
 #define F_CPU 16000000UL
@@ -20,16 +22,14 @@
 #define I2C_KEYMAP_START    0x06
 
 // Slave buffer (8bit per)
-// Rows per hand + backlit space + rgb space
-// TODO : Make this dynamically sized
-#define SLAVE_BUFFER_SIZE 0x20
+// backlit space + rgb space + packed rows of the slave half
+#define SLAVE_BUFFER_SIZE (I2C_KEYMAP_START + HALF_MATRIX_BYTES)
 
 // i2c SCL clock frequency
 #ifndef SCL_CLOCK
 #define SCL_CLOCK  100000L
 #endif
 
-// Support 8bits right now (8 cols) will need to edit to take higher (code exists in delta split?)
 extern volatile uint8_t i2c_slave_buffer[SLAVE_BUFFER_SIZE];
 
 void i2c_master_init(void);
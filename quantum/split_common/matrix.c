@@ -31,6 +31,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "config.h"
 #include "timer.h"
 #include "split_flags.h"
+#include "debounce.h"
+#include "split_rows.h"
 
 #ifdef RGBLIGHT_ENABLE
 #   include "rgblight.h"
@@ -46,37 +48,33 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #  include "serial.h"
 #endif
 
-#ifndef DEBOUNCING_DELAY
-#   define DEBOUNCING_DELAY 5
-#endif
-
-#if (DEBOUNCING_DELAY > 0)
-    static uint16_t debouncing_time;
-    static bool debouncing = false;
-#endif
-
 #if (MATRIX_COLS <= 8)
 #    define print_matrix_header()  print("\nr/c 01234567\n")
 #    define print_matrix_row(row)  print_bin_reverse8(matrix_get_row(row))
 #    define matrix_bitpop(i)       bitpop(matrix[i])
 #    define ROW_SHIFTER ((uint8_t)1)
-#else
-#    error "Currently only supports 8 COLS"
+#elif (MATRIX_COLS <= 16)
+#    define print_matrix_header()  print("\nr/c 0123456789ABCDEF\n")
+#    define print_matrix_row(row)  print_bin_reverse16(matrix_get_row(row))
+#    define matrix_bitpop(i)       bitpop16(matrix[i])
+#    define ROW_SHIFTER ((uint16_t)1)
+#elif (MATRIX_COLS <= 32)
+#    define print_matrix_header()  print("\nr/c 0123456789ABCDEF0123456789ABCDEF\n")
+#    define print_matrix_row(row)  print_bin_reverse32(matrix_get_row(row))
+#    define matrix_bitpop(i)       bitpop32(matrix[i])
+#    define ROW_SHIFTER  ((uint32_t)1)
 #endif
-static matrix_row_t matrix_debouncing[MATRIX_ROWS];
 
 #define ERROR_DISCONNECT_COUNT 5
 
-#define ROWS_PER_HAND (MATRIX_ROWS/2)
-
 static uint8_t error_count = 0;
 
 static uint8_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
 static uint8_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
 
 /* matrix state(1:on, 0:off) */
-static matrix_row_t matrix[MATRIX_ROWS];
-static matrix_row_t matrix_debouncing[MATRIX_ROWS];
+static matrix_row_t raw_matrix[MATRIX_ROWS]; //raw values
+static matrix_row_t matrix[MATRIX_ROWS]; //debounced values
 
 #if (DIODE_DIRECTION == COL2ROW)
     static void init_cols(void);
@@ -163,9 +161,11 @@ void matrix_init(void)
 
     // initialize matrix state: all keys off
     for (uint8_t i=0; i < MATRIX_ROWS; i++) {
+        raw_matrix[i] = 0;
         matrix[i] = 0;
-        matrix_debouncing[i] = 0;
     }
+
+    debounce_init(ROWS_PER_HAND);
     
     matrix_init_quantum();
     
@@ -174,47 +174,20 @@ void matrix_init(void)
 uint8_t _matrix_scan(void)
 {
     int offset = isLeftHand ? 0 : (ROWS_PER_HAND);
+    bool changed = false;
 #if (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
-#       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_cols_on_row(matrix_debouncing+offset, current_row);
-
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
-
-#       else
-            read_cols_on_row(matrix+offset, current_row);
-#       endif
-
+        changed |= read_cols_on_row(raw_matrix+offset, current_row);
     }
-
 #elif (DIODE_DIRECTION == ROW2COL)
     // Set col, read rows
     for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++) {
-#       if (DEBOUNCING_DELAY > 0)
-            bool matrix_changed = read_rows_on_col(matrix_debouncing+offset, current_col);
-            if (matrix_changed) {
-                debouncing = true;
-                debouncing_time = timer_read();
-            }
-#       else
-             read_rows_on_col(matrix+offset, current_col);
-#       endif
-
+        changed |= read_rows_on_col(raw_matrix+offset, current_col);
     }
 #endif
 
-#   if (DEBOUNCING_DELAY > 0)
-        if (debouncing && (timer_elapsed(debouncing_time) > DEBOUNCING_DELAY)) {
-            for (uint8_t i = 0; i < ROWS_PER_HAND; i++) {
-                matrix[i+offset] = matrix_debouncing[i+offset];
-            }
-            debouncing = false;
-        }
-#   endif
+    debounce(raw_matrix+offset, matrix+offset, ROWS_PER_HAND, changed);
 
     return 1;
 }
@@ -255,12 +228,14 @@ int i2c_transaction(void) {
     if (err) goto i2c_error;
 
     if (!err) {
-        int i;
-        for (i = 0; i < ROWS_PER_HAND-1; ++i) {
-            matrix[slaveOffset+i] = i2c_master_read(I2C_ACK);
+        uint8_t rows[HALF_MATRIX_BYTES];
+        uint8_t i;
+        for (i = 0; i < HALF_MATRIX_BYTES-1; ++i) {
+            rows[i] = i2c_master_read(I2C_ACK);
         }
-        matrix[slaveOffset+i] = i2c_master_read(I2C_NACK);
+        rows[i] = i2c_master_read(I2C_NACK);
         i2c_master_stop();
+        split_rows_unpack(&matrix[slaveOffset], rows);
     } else {
 i2c_error: // the cable is disconnceted, or something else went wrong
         i2c_reset_state();
@@ -299,9 +274,7 @@ int serial_transaction(void) {
         return 1;
     }
 
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        matrix[slaveOffset+i] = serial_slave_buffer[i];
-    }
+    split_rows_unpack(&matrix[slaveOffset], serial_slave_buffer);
     
     #ifdef RGBLIGHT_ENABLE
         // Code to send RGB over serial goes here (not implemented yet)
@@ -348,27 +321,16 @@ void matrix_slave_scan(void) {
     int offset = (isLeftHand) ? 0 : ROWS_PER_HAND;
 
 #if defined(USE_I2C) || defined(EH)
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        i2c_slave_buffer[I2C_KEYMAP_START+i] = matrix[offset+i];
-    }   
+    split_rows_pack(&i2c_slave_buffer[I2C_KEYMAP_START], &matrix[offset]);
 #else // USE_SERIAL
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        serial_slave_buffer[i] = matrix[offset+i];
-    }
+    split_rows_pack(serial_slave_buffer, &matrix[offset]);
 #endif
 #ifdef USE_I2C
 #ifdef BACKLIGHT_ENABLE
     // Read backlight level sent from master and update level on slave
     backlight_set(i2c_slave_buffer[0]);
 #endif
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        i2c_slave_buffer[i+1] = matrix[offset+i];
-    }
 #else // USE_SERIAL
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        serial_slave_buffer[i] = matrix[offset+i];
-    }
-
 #ifdef BACKLIGHT_ENABLE
     // Read backlight level sent from master and update level on slave
     backlight_set(serial_master_buffer[SERIAL_BACKLIT_START]);
@@ -379,7 +341,7 @@ void matrix_slave_scan(void) {
 
 bool matrix_is_modified(void)
 {
-    if (debouncing) return false;
+    if (debounce_active()) return false;
     return true;
 }
 
@@ -397,10 +359,11 @@ matrix_row_t matrix_get_row(uint8_t row)
 
 void matrix_print(void)
 {
-    print("\nr/c 0123456789ABCDEF\n");
+    print_matrix_header();
+
     for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
         phex(row); print(": ");
-        pbin_reverse16(matrix_get_row(row));
+        print_matrix_row(row);
         print("\n");
     }
 }
@@ -409,7 +372,7 @@ uint8_t matrix_key_count(void)
 {
     uint8_t count = 0;
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
-        count += bitpop16(matrix[i]);
+        count += matrix_bitpop(i);
     }
     return count;
 }
@@ -1,8 +1,9 @@
 #ifndef MY_SERIAL_H
 #define MY_SERIAL_H
 
-#include "config.h"
 #include <stdbool.h>
+#include "matrix.h"
+#include "split_rows.h"
 
 /* TODO:  some defines for interrupt setup */
 #define SERIAL_PIN_DDR DDRD
@@ -11,7 +12,8 @@
 #define SERIAL_PIN_MASK _BV(PD0)
 #define SERIAL_PIN_INTERRUPT INT0_vect
 
-#define SERIAL_SLAVE_BUFFER_LENGTH MATRIX_ROWS/2
+// Slave half of the matrix, packed rows
+#define SERIAL_SLAVE_BUFFER_LENGTH HALF_MATRIX_BYTES
 #define SERIAL_MASTER_BUFFER_LENGTH 1
 
 // Address location defines 
@@ -0,0 +1,34 @@
+#ifndef SPLIT_ROWS_H
+#define SPLIT_ROWS_H
+
+#include <stdint.h>
+#include "matrix.h"
+
+#define ROWS_PER_HAND (MATRIX_ROWS/2)
+
+/* Each half is sent as its rows packed back to back, sizeof(matrix_row_t)
+ * bytes per row, least significant byte first, in one transaction.
+ */
+#define HALF_MATRIX_BYTES (ROWS_PER_HAND * sizeof(matrix_row_t))
+
+static inline void split_rows_pack(volatile uint8_t *buffer, const matrix_row_t *rows)
+{
+    for (uint8_t r = 0; r < ROWS_PER_HAND; ++r) {
+        for (uint8_t b = 0; b < sizeof(matrix_row_t); ++b) {
+            *buffer++ = rows[r] >> (8 * b);
+        }
+    }
+}
+
+static inline void split_rows_unpack(matrix_row_t *rows, const volatile uint8_t *buffer)
+{
+    for (uint8_t r = 0; r < ROWS_PER_HAND; ++r) {
+        matrix_row_t row = 0;
+        for (uint8_t b = 0; b < sizeof(matrix_row_t); ++b) {
+            row |= (matrix_row_t)*buffer++ << (8 * b);
+        }
+        rows[r] = row;
+    }
+}
+
+#endif
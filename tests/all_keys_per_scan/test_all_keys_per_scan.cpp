@@ -0,0 +1,112 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class AllKeysPerScan : public TestFixture {};
+
+TEST_F(AllKeysPerScan, SixKeyChordIsReportedInOneScan) {
+    TestDriver driver;
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(0, 1);
+    press_key(1, 1);
+    press_key(0, 3);
+    press_key(1, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E, KC_F)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(0, 1);
+    release_key(1, 1);
+    release_key(0, 3);
+    release_key(1, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(AllKeysPerScan, ModifierAndKeyAreReportedTogether) {
+    TestDriver driver;
+    press_key(3, 0);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(3, 0);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(AllKeysPerScan, ColumnsAboveEightAreProcessed) {
+    TestDriver driver;
+    press_key(9, 3);
+    press_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_G)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(9, 3);
+    release_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(AllKeysPerScan, ReleaseAndPressInTheSameScanAreBothReported) {
+    TestDriver driver;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    press_key(1, 0);
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    }
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(AllKeysPerScan, MacroTapsAreNotMerged) {
+    TestDriver driver;
+    press_key(8, 0);
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_H)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_I)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(8, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+}
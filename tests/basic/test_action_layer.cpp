@@ -90,3 +90,51 @@ TEST_F(ActionLayer, LayerStateCmp) {
 //     layer_off(2);
 //     EXPECT_EQ(layer_state, 0b1000);
 // }
+
+TEST_F(ActionLayer, LayerChangeClearsHeldKeys) {
+    TestDriver driver;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    layer_on(1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    layer_off(1);
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    default_layer_set(default_layer_state);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    run_one_scan_loop();
+}
+
+TEST_F(ActionLayer, LayerChangeWithOnlyModsHeldSendsNoReport) {
+    TestDriver driver;
+
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // both layer state paths agree
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    layer_on(1);
+    layer_off(1);
+    default_layer_set(default_layer_state);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
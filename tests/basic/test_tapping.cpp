@@ -95,3 +95,62 @@ TEST_F(Tapping, ANewTapWithinTappingTermIsBuggy) {
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).Times(1);
     idle_for(TAPPING_TERM);
 }
+
+TEST_F(Tapping, InterruptedSHFT_T_KeyIsPressedOnce) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // the interrupted tap is taken as a hold, and shift is pressed only once
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(Tapping, TapKeyReleasedByTheNextTapKeyIsReleasedOnce) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(7, 0);
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    // the second tap holds KC_P until the next tap key releases it
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    run_one_scan_loop();
+    press_key(9, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(9, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // by now neither its key nor its mods are held
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+}
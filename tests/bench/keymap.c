@@ -0,0 +1,48 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+#define TRANSPARENT_LAYER { \
+    {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS}, \
+    {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS}, \
+    {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS}, \
+    {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS}, \
+}
+
+// The traces in test_bench.cpp refer to these positions
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        // 0    1      2      3        4        5        6       7            8      9
+        {KC_Q,  KC_W,  KC_E,  KC_R,    KC_T,    KC_Y,    KC_U,   KC_I,        KC_O,  KC_P},
+        {KC_A,  KC_S,  KC_D,  KC_F,    KC_G,    KC_H,    KC_J,   KC_K,        KC_L,  KC_SCLN},
+        {KC_Z,  KC_X,  KC_C,  KC_V,    KC_B,    KC_N,    KC_M,   KC_COMM,     KC_DOT,KC_SLSH},
+        {KC_LSFT, KC_LCTL, KC_SPC, TD(0), SFT_T(KC_ENT), MO(1), KC_NO, KC_NO,   KC_NO, KC_NO},
+    },
+    [1 ... 31] = TRANSPARENT_LAYER,
+};
+
+const uint16_t PROGMEM combo_qw[] = {KC_Q, KC_W, COMBO_END};
+const uint16_t PROGMEM combo_as[] = {KC_A, KC_S, COMBO_END};
+
+combo_t key_combos[COMBO_COUNT] = {
+    COMBO(combo_qw, KC_ESC),
+    COMBO(combo_as, KC_TAB),
+};
+
+qk_tap_dance_action_t tap_dance_actions[] = {
+    [0] = ACTION_TAP_DANCE_DOUBLE(KC_MINS, KC_EQL),
+};
@@ -0,0 +1,101 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "trace.hpp"
+#include "test_matrix.h"
+
+extern "C" {
+#include "quantum.h"
+}
+
+// Avoids the combo keys q, w, a and s, which are held back until the combo is decided
+static const char* const sentence = "by the time the fox lit the bonfire the dog jumped over the fence";
+
+class Bench : public testing::Test {
+public:
+    static void SetUpTestCase() {
+        keyboard_init();
+    }
+
+    void SetUp() override {
+        keymap_config.nkro = false;
+        layer_clear();
+        clear_all_keys();
+    }
+
+    void TearDown() override {
+        keymap_config.nkro = false;
+        layer_clear();
+        clear_all_keys();
+    }
+
+    void report(const char* name, const BenchResult& result) {
+        print_bench_result(name, result);
+        RecordProperty("scans_per_second", static_cast<int>(result.scans_per_second()));
+        RecordProperty("ns_per_event", static_cast<int>(result.ns_per_event()));
+        RecordProperty("reports_per_keystroke_x100", static_cast<int>(result.reports_per_keystroke() * 100));
+    }
+};
+
+TEST_F(Bench, Typing) {
+    BenchResult result = replay_trace(typing_trace(sentence, 60, 80), BENCH_ITERATIONS);
+    report("typing", result);
+    EXPECT_EQ(result.reports, 2 * result.keystrokes);
+}
+
+TEST_F(Bench, TypingNkro) {
+    keymap_config.nkro = true;
+    BenchResult result = replay_trace(typing_trace(sentence, 60, 80), BENCH_ITERATIONS);
+    report("typing nkro", result);
+    EXPECT_EQ(result.reports, 2 * result.keystrokes);
+}
+
+TEST_F(Bench, Typing32Layers) {
+    // Every layer is transparent, so each press searches all of them
+    layer_state_set(UINT32_MAX);
+    BenchResult result = replay_trace(typing_trace(sentence, 60, 80), BENCH_ITERATIONS);
+    report("typing 32 layers", result);
+    EXPECT_EQ(result.reports, 2 * result.keystrokes);
+}
+
+TEST_F(Bench, Combos) {
+    const Trace trace = {
+        // q+w chord fires KC_ESC
+        {0, 0, 0, true}, {10, 1, 0, true}, {80, 0, 0, false}, {85, 1, 0, false},
+        // a+s chord fires KC_TAB
+        {200, 0, 1, true}, {205, 1, 1, true}, {270, 1, 1, false}, {280, 0, 1, false},
+        // q tapped on its own
+        {400, 0, 0, true}, {450, 0, 0, false},
+        // e is not part of any combo
+        {500, 2, 0, true}, {550, 2, 0, false},
+    };
+    BenchResult result = replay_trace(trace, BENCH_ITERATIONS);
+    report("combos", result);
+    EXPECT_GT(result.reports, 0u);
+}
+
+TEST_F(Bench, TapDance) {
+    const Trace trace = {
+        // double tap
+        {0, 3, 3, true}, {40, 3, 3, false}, {90, 3, 3, true}, {130, 3, 3, false},
+        // single tap
+        {600, 3, 3, true}, {640, 3, 3, false},
+    };
+    BenchResult result = replay_trace(trace, BENCH_ITERATIONS);
+    report("tap dance", result);
+    EXPECT_GT(result.reports, 0u);
+}
@@ -0,0 +1,129 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "test_matrix.h"
+
+extern "C" {
+#include "host.h"
+#include "keyboard.h"
+#include "action.h"
+#include "action_tapping.h"
+    void advance_time(uint32_t ms);
+}
+
+// Reports are only counted, so the harness adds as little as possible to the
+// measured time
+static uint32_t report_count;
+
+static uint8_t bench_keyboard_leds(void) { return 0; }
+static void bench_send_keyboard(report_keyboard_t*) { report_count++; }
+static void bench_send_mouse(report_mouse_t*) {}
+static void bench_send_system(uint16_t) {}
+static void bench_send_consumer(uint16_t) {}
+
+static host_driver_t bench_driver = {
+    bench_keyboard_leds,
+    bench_send_keyboard,
+    bench_send_mouse,
+    bench_send_system,
+    bench_send_consumer
+};
+
+static const char* const bench_rows[] = {
+    "qwertyuiop",
+    "asdfghjkl;",
+    "zxcvbnm,./",
+};
+
+Trace typing_trace(const char* text, uint16_t interval, uint16_t hold) {
+    Trace trace;
+    uint16_t time = 0;
+    for (const char* c = text; *c; c++, time += interval) {
+        uint8_t row, col;
+        if (*c == ' ') {
+            row = 3;
+            col = 2;
+        } else {
+            for (row = 0; row < 3 && !std::strchr(bench_rows[row], *c); row++)
+                ;
+            if (row == 3) continue;
+            col = std::strchr(bench_rows[row], *c) - bench_rows[row];
+        }
+        trace.push_back({time, col, row, true});
+        trace.push_back({static_cast<uint16_t>(time + hold), col, row, false});
+    }
+    std::stable_sort(trace.begin(), trace.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.time < b.time;
+    });
+    return trace;
+}
+
+BenchResult replay_trace(const Trace& trace, unsigned iterations) {
+    BenchResult result = {};
+    const uint16_t end = trace.back().time + TAPPING_TERM + 50;
+    for (const TraceEvent& event : trace) {
+        result.events++;
+        if (event.pressed) result.keystrokes++;
+    }
+    result.events *= iterations;
+    result.keystrokes *= iterations;
+
+    host_set_driver(&bench_driver);
+    report_count = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        auto next = trace.begin();
+        for (uint16_t t = 0; t <= end; t++) {
+            for (; next != trace.end() && next->time <= t; ++next) {
+                if (next->pressed) {
+                    press_key(next->col, next->row);
+                } else {
+                    release_key(next->col, next->row);
+                }
+            }
+            keyboard_task();
+            advance_time(1);
+            result.scans++;
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+    result.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+    result.reports = report_count;
+    host_set_driver(nullptr);
+    return result;
+}
+
+double BenchResult::scans_per_second() const {
+    return nanoseconds ? scans * 1e9 / nanoseconds : 0;
+}
+
+double BenchResult::ns_per_event() const {
+    return events ? static_cast<double>(nanoseconds) / events : 0;
+}
+
+double BenchResult::reports_per_keystroke() const {
+    return keystrokes ? static_cast<double>(reports) / keystrokes : 0;
+}
+
+void print_bench_result(const char* name, const BenchResult& result) {
+    std::printf("[ BENCH    ] %-16s %12.0f scans/s %10.1f ns/event %6.2f reports/keystroke\n",
+        name, result.scans_per_second(), result.ns_per_event(), result.reports_per_keystroke());
+}
@@ -0,0 +1,52 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// One recorded switch transition
+struct TraceEvent {
+    uint16_t time; // ms since the start of the trace
+    uint8_t col;
+    uint8_t row;
+    bool pressed;
+};
+
+typedef std::vector<TraceEvent> Trace;
+
+struct BenchResult {
+    uint32_t scans;
+    uint32_t events;
+    uint32_t keystrokes;
+    uint32_t reports;
+    uint64_t nanoseconds;
+
+    double scans_per_second() const;
+    double ns_per_event() const;
+    double reports_per_keystroke() const;
+};
+
+// Builds a rolled-over typing trace for text on the bench keymap, pressing a
+// key every interval ms and holding each one for hold ms
+Trace typing_trace(const char* text, uint16_t interval, uint16_t hold);
+
+// Replays the trace through keyboard_task() one 1ms scan at a time, then keeps
+// scanning until tapping, tap dance and combo timers have expired
+BenchResult replay_trace(const Trace& trace, unsigned iterations);
+
+void print_bench_result(const char* name, const BenchResult& result);
@@ -0,0 +1,152 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class ComboIndex : public TestFixture {};
+
+TEST_F(ComboIndex, NonComboKeyIsNotHeldBack) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ComboIndex, EachTwoKeyComboFires) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    idle_for(COMBO_TERM);
+    press_key(2, 0);
+    run_one_scan_loop();
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_TAB)));
+    run_one_scan_loop();
+    release_key(2, 0);
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+}
+
+TEST_F(ComboIndex, ThreeKeyCombo) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 1);
+    run_one_scan_loop();
+    press_key(2, 1);
+    run_one_scan_loop();
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ENT)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    release_key(1, 1);
+    release_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(3);
+}
+
+TEST_F(ComboIndex, LoneComboKeyIsTapped) {
+    TestDriver driver;
+    InSequence s;
+
+    combo_index_invalidate();
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    release_key(0, 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ComboIndex, ComboKeysTimeOutInTurn) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM / 2);
+    press_key(2, 0);
+    idle_for(COMBO_TERM / 2 - 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // a few scans of slack for the odd event time stamps
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    idle_for(4);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM / 2 - 4);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q, KC_E)));
+    idle_for(4);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E)));
+    run_one_scan_loop();
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ComboIndex, InvalidatingForgetsCombosInProgress) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    combo_index_invalidate();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM * 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // combos started after it time out again
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    idle_for(COMBO_TERM + 4);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,35 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_Q, KC_W, KC_E, KC_R, KC_Z},
+        {KC_A, KC_S, KC_D, KC_NO, KC_NO},
+    },
+};
+
+// listed out of keycode order
+const uint16_t PROGMEM qw_combo[] = {KC_W, KC_Q, COMBO_END};
+const uint16_t PROGMEM er_combo[] = {KC_R, KC_E, COMBO_END};
+const uint16_t PROGMEM asd_combo[] = {KC_S, KC_D, KC_A, COMBO_END};
+
+combo_t key_combos[COMBO_COUNT] = {
+    COMBO(qw_combo, KC_ESC),
+    COMBO(er_combo, KC_TAB),
+    COMBO(asd_combo, KC_ENT),
+};
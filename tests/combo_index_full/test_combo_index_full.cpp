@@ -0,0 +1,35 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+extern combo_t key_combos[COMBO_COUNT];
+}
+
+// the combo_index tests run on this build too, see rules.mk
+class ComboIndexFull : public TestFixture {};
+
+TEST_F(ComboIndexFull, CombosHaveMoreKeysThanTheIndex) {
+    uint16_t keys = 0;
+    for (uint8_t c = 0; c < COMBO_COUNT; c++) {
+        for (const uint16_t *key = key_combos[c].keys; pgm_read_word(key) != COMBO_END; key++) {
+            keys++;
+        }
+    }
+    EXPECT_GT(keys, COMBO_INDEX_SIZE);
+    EXPECT_TRUE(combo_index_is_full());
+}
@@ -0,0 +1,60 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test.hpp"
+
+class DebounceEagerPk : public DebounceTest {};
+
+TEST_F(DebounceEagerPk, PressIsCommittedImmediately) {
+    set_key(0, 0, true);
+    scan();
+    EXPECT_TRUE(is_pressed(0, 0));
+}
+
+TEST_F(DebounceEagerPk, BouncesDuringTheLockAreIgnored) {
+    set_key(0, 0, true);
+    scan();
+    for (int i = 0; i < DEBOUNCING_DELAY - 1; i++) {
+        set_key(0, 0, i & 1);
+        scan();
+        EXPECT_TRUE(is_pressed(0, 0));
+    }
+    set_key(0, 0, true);
+    scan_for(DEBOUNCING_DELAY * 2);
+    EXPECT_TRUE(is_pressed(0, 0));
+}
+
+TEST_F(DebounceEagerPk, ReleaseDuringTheLockIsCommittedWhenTheLockEnds) {
+    set_key(0, 0, true);
+    scan();
+    set_key(0, 0, false);
+    scan_for(DEBOUNCING_DELAY - 1);
+    EXPECT_TRUE(is_pressed(0, 0));
+    scan();
+    EXPECT_FALSE(is_pressed(0, 0));
+}
+
+TEST_F(DebounceEagerPk, LockedKeyDoesNotDelayOtherKeys) {
+    set_key(0, 0, true);
+    scan();
+    set_key(1, 2, true);
+    scan();
+    EXPECT_TRUE(is_pressed(1, 2));
+}
+
+TEST_F(DebounceEagerPk, ScanCost) {
+    report_scan_cost("debounce eager_pk");
+}
@@ -0,0 +1,38 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test.hpp"
+
+class DebounceEagerPkLarge : public DebounceTest {};
+
+TEST_F(DebounceEagerPkLarge, EveryKeyPressedInOneScanIsUnlocked) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            set_key(col, row, true);
+        }
+    }
+    scan();
+    ASSERT_TRUE(is_pressed(MATRIX_COLS - 1, MATRIX_ROWS - 1));
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        raw[row] = 0;
+    }
+    scan_for(DEBOUNCING_DELAY + 1);
+    EXPECT_FALSE(is_pressed(0, 0));
+    EXPECT_FALSE(is_pressed(MATRIX_COLS - 1, MATRIX_ROWS - 1));
+    // the releases lock the keys again, and those locks end too
+    scan_for(DEBOUNCING_DELAY);
+    EXPECT_FALSE(debounce_active());
+}
@@ -0,0 +1,69 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test.hpp"
+
+class DebounceSymPk : public DebounceTest {};
+
+TEST_F(DebounceSymPk, PressIsCommittedAfterTheDelay) {
+    set_key(0, 0, true);
+    scan_for(DEBOUNCING_DELAY);
+    EXPECT_FALSE(is_pressed(0, 0));
+    scan();
+    EXPECT_TRUE(is_pressed(0, 0));
+}
+
+TEST_F(DebounceSymPk, ReleaseIsCommittedAfterTheDelay) {
+    set_key(0, 0, true);
+    scan_for(DEBOUNCING_DELAY + 1);
+    ASSERT_TRUE(is_pressed(0, 0));
+    set_key(0, 0, false);
+    scan_for(DEBOUNCING_DELAY);
+    EXPECT_TRUE(is_pressed(0, 0));
+    scan();
+    EXPECT_FALSE(is_pressed(0, 0));
+}
+
+TEST_F(DebounceSymPk, BounceShorterThanTheDelayIsFiltered) {
+    set_key(0, 0, true);
+    scan_for(2);
+    set_key(0, 0, false);
+    scan_for(DEBOUNCING_DELAY * 4);
+    EXPECT_FALSE(is_pressed(0, 0));
+}
+
+TEST_F(DebounceSymPk, ChatteringKeyDoesNotDelayOtherKeys) {
+    set_key(0, 0, true);
+    for (int i = 0; i < 10; i++) {
+        set_key(1, 2, i & 1);
+        scan_for(2);
+    }
+    EXPECT_TRUE(is_pressed(0, 0));
+    EXPECT_FALSE(is_pressed(1, 2));
+}
+
+TEST_F(DebounceSymPk, KeysInTheSameScanAreCommittedTogether) {
+    set_key(0, 0, true);
+    set_key(9, 3, true);
+    scan_for(DEBOUNCING_DELAY + 1);
+    EXPECT_TRUE(is_pressed(0, 0));
+    EXPECT_TRUE(is_pressed(9, 3));
+    EXPECT_FALSE(debounce_active());
+}
+
+TEST_F(DebounceSymPk, ScanCost) {
+    report_scan_cost("debounce sym_pk");
+}
@@ -0,0 +1,31 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test.hpp"
+
+class DebounceSymPkLarge : public DebounceTest {};
+
+TEST_F(DebounceSymPkLarge, EveryKeyPressedInOneScanIsCommitted) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            set_key(col, row, true);
+        }
+    }
+    scan_for(DEBOUNCING_DELAY + 1);
+    EXPECT_TRUE(is_pressed(0, 0));
+    EXPECT_TRUE(is_pressed(MATRIX_COLS - 1, MATRIX_ROWS - 1));
+    EXPECT_FALSE(debounce_active());
+}
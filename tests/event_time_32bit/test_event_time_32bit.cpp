@@ -0,0 +1,108 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" {
+    void set_time(uint32_t t);
+    void advance_time(uint32_t ms);
+}
+
+class EventTime32Bit : public TestFixture {};
+
+TEST_F(EventTime32Bit, EventTimeIsWide) {
+    EXPECT_EQ(sizeof(event_time_t), 4u);
+    EXPECT_EQ(sizeof(((keyevent_t *)0)->time), 4u);
+}
+
+TEST_F(EventTime32Bit, TapAcrossTheTimerWrap) {
+    TestDriver driver;
+    InSequence s;
+
+    set_time(UINT32_MAX - 50);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(100);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+}
+
+TEST_F(EventTime32Bit, HoldAcrossTheTimerWrap) {
+    TestDriver driver;
+    InSequence s;
+
+    // event times are rounded up to odd, so the hold lands on one of two scans
+    set_time(UINT32_MAX - 100);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    idle_for(2);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(EventTime32Bit, TapKeyIsForgottenAfter16BitPeriod) {
+    TestDriver driver;
+    InSequence s;
+
+    set_time(0x10000 - 20);
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // no scans while suspended; a 16 bit time would see a second tap here
+    advance_time(0x10000);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    idle_for(2);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(EventTime32Bit, OneshotModTimesOutAfter16BitPeriod) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    advance_time(0x10000 + 10);
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    run_one_scan_loop();
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
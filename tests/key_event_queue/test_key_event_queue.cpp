@@ -0,0 +1,118 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+extern uint16_t recorded_times[16];
+extern uint8_t recorded_count;
+}
+
+using testing::_;
+using testing::InSequence;
+
+class KeyEventQueue : public TestFixture {
+public:
+    void SetUp() override {
+        recorded_count = 0;
+    }
+};
+
+TEST_F(KeyEventQueue, ChordIsDispatchedOneKeyPerScan) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    run_one_scan_loop();
+    run_one_scan_loop();
+}
+
+TEST_F(KeyEventQueue, ChordEventsKeepTheirScanTime) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(2, 0);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    ASSERT_EQ(recorded_count, 3);
+    EXPECT_EQ(recorded_times[1], recorded_times[0]);
+    EXPECT_EQ(recorded_times[2], recorded_times[0]);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(2, 0);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    ASSERT_EQ(recorded_count, 6);
+    EXPECT_EQ(recorded_times[4], recorded_times[3]);
+    EXPECT_EQ(recorded_times[5], recorded_times[3]);
+    EXPECT_NE(recorded_times[3], recorded_times[0]);
+}
+
+TEST_F(KeyEventQueue, EdgesBeyondTheQueueSizeAreDeferred) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(2, 0);
+    press_key(3, 0);
+    press_key(4, 0);
+    press_key(5, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E, KC_F)));
+    for (int i = 0; i < 6; i++) {
+        run_one_scan_loop();
+    }
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    ASSERT_EQ(recorded_count, 6);
+    EXPECT_EQ(recorded_times[3], recorded_times[0]);
+    // E and F only fit once earlier events have been dispatched
+    EXPECT_GT(recorded_times[5], recorded_times[0]);
+
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(2, 0);
+    release_key(3, 0);
+    release_key(4, 0);
+    release_key(5, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(6);
+    for (int i = 0; i < 6; i++) {
+        run_one_scan_loop();
+    }
+}
@@ -0,0 +1,59 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+class KeycodeConfig : public TestFixture {
+public:
+    void TearDown() override {
+        keymap_config.raw = 0;
+    }
+};
+
+TEST_F(KeycodeConfig, NoOptionsLeaveEveryKeycodeAlone) {
+    keymap_config.raw = 0;
+    for (uint32_t keycode = 0; keycode <= 0xFFFF; keycode++) {
+        ASSERT_EQ(keycode_config(keycode), keycode);
+    }
+    for (uint16_t mod = 0; mod <= 0x1F; mod++) {
+        ASSERT_EQ(mod_config(mod), mod);
+    }
+}
+
+TEST_F(KeycodeConfig, NkroAloneRemapsNothing) {
+    keymap_config.nkro = true;
+    EXPECT_EQ(keycode_config(KC_CAPSLOCK), KC_CAPSLOCK);
+    EXPECT_EQ(keycode_config(KC_LGUI), KC_LGUI);
+    EXPECT_EQ(mod_config(MOD_LGUI), MOD_LGUI);
+}
+
+TEST_F(KeycodeConfig, OptionsStillRemap) {
+    keymap_config.swap_grave_esc = true;
+    EXPECT_EQ(keycode_config(KC_GRAVE), KC_ESC);
+    EXPECT_EQ(keycode_config(KC_ESC), KC_GRAVE);
+    EXPECT_EQ(keycode_config(KC_LGUI), KC_LGUI);
+    EXPECT_EQ(mod_config(MOD_LGUI), MOD_LGUI);
+
+    keymap_config.raw = 0;
+    keymap_config.swap_lalt_lgui = true;
+    EXPECT_EQ(keycode_config(KC_LGUI), KC_LALT);
+    EXPECT_EQ(mod_config(MOD_LGUI), MOD_LALT);
+
+    keymap_config.raw = 0;
+    keymap_config.no_gui = true;
+    EXPECT_EQ(keycode_config(KC_RGUI), KC_NO);
+    EXPECT_EQ(mod_config(MOD_LGUI | MOD_LSFT), MOD_LSFT);
+}
@@ -0,0 +1,63 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+extern uint16_t decoder_test_keycode;
+action_t reference_action_for_keycode(uint16_t keycode);
+}
+
+class KeycodeDecoder : public TestFixture {
+public:
+    uint16_t decode(uint16_t keycode) {
+        decoder_test_keycode = keycode;
+        return action_for_key(0, (keypos_t){ .col = 0, .row = 0 }).code;
+    }
+};
+
+TEST_F(KeycodeDecoder, EveryKeycodeDecodesLikeTheSwitch) {
+    unsigned mismatches = 0;
+    for (uint32_t keycode = 0; keycode <= 0xFFFF; keycode++) {
+        uint16_t expected = reference_action_for_keycode(keycode).code;
+        uint16_t actual = decode(keycode);
+        if (actual != expected && mismatches++ < 10) {
+            ADD_FAILURE() << "keycode 0x" << std::hex << keycode << " decoded to 0x" << actual << ", expected 0x" << expected;
+        }
+    }
+    EXPECT_EQ(mismatches, 0u);
+}
+
+TEST_F(KeycodeDecoder, RangesDecodeToTheirActions) {
+    EXPECT_EQ(decode(KC_NO), ACTION_NO);
+    EXPECT_EQ(decode(KC_TRNS), ACTION_TRANSPARENT);
+    EXPECT_EQ(decode(KC_A), ACTION_KEY(KC_A));
+    EXPECT_EQ(decode(KC_FN3), 0xA003);
+    EXPECT_EQ(decode(LCTL(KC_C)), ACTION_MODS_KEY(MOD_LCTL, KC_C));
+    EXPECT_EQ(decode(F(0x123)), 0xA123);
+    EXPECT_EQ(decode(LT(2, KC_SPC)), ACTION_LAYER_TAP_KEY(2, KC_SPC));
+    EXPECT_EQ(decode(TO(3)), ACTION_LAYER_SET(3, ON_PRESS));
+    EXPECT_EQ(decode(MO(4)), ACTION_LAYER_MOMENTARY(4));
+    EXPECT_EQ(decode(DF(1)), ACTION_DEFAULT_LAYER_SET(1));
+    EXPECT_EQ(decode(TG(5)), ACTION_LAYER_TOGGLE(5));
+    EXPECT_EQ(decode(OSL(6)), ACTION_LAYER_ONESHOT(6));
+    EXPECT_EQ(decode(OSM(MOD_LSFT)), ACTION_MODS_ONESHOT(MOD_LSFT));
+    EXPECT_EQ(decode(TT(7)), ACTION_LAYER_TAP_TOGGLE(7));
+    EXPECT_EQ(decode(LM(2, MOD_LALT)), ACTION_LAYER_MODS(2, MOD_LALT));
+    EXPECT_EQ(decode(MT(MOD_LGUI, KC_ESC)), ACTION_MODS_TAP_KEY(MOD_LGUI, KC_ESC));
+    EXPECT_EQ(decode(RESET), ACTION_NO);
+    EXPECT_EQ(decode(0x9234), ACTION_NO);
+}
@@ -0,0 +1,150 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "latency_stats.h"
+#include "action_tapping.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class LatencyStats : public TestFixture {
+public:
+    LatencyStats() {
+        latency_stats_clear();
+    }
+};
+
+TEST_F(LatencyStats, KeyReportedInTheSameScanIsInTheFirstBucket) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    const latency_stats_t* stats = latency_stats_get();
+    EXPECT_EQ(stats->buckets[0], 2);
+    EXPECT_EQ(stats->count, 2);
+    EXPECT_EQ(stats->max, 0);
+}
+
+TEST_F(LatencyStats, TapIsMeasuredFromThePress) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(7, 0);
+    run_one_scan_loop();
+    idle_for(19);
+    release_key(7, 0);
+    run_one_scan_loop();
+    const latency_stats_t* stats = latency_stats_get();
+    // the press is held back until the release sends the tap
+    EXPECT_EQ(stats->buckets[5], 1);
+    EXPECT_EQ(stats->count, 1);
+    EXPECT_GE(stats->max, 19);
+    EXPECT_LE(stats->max, 22);
+}
+
+TEST_F(LatencyStats, HoldIsMeasuredFromThePress) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(7, 0);
+    idle_for(TAPPING_TERM + 2);
+    const latency_stats_t* stats = latency_stats_get();
+    EXPECT_EQ(stats->count, 1);
+    EXPECT_GE(stats->max, TAPPING_TERM - 1);
+    EXPECT_LE(stats->max, TAPPING_TERM + 1);
+    release_key(7, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(LatencyStats, KeysLeftForLaterScansAreStampedByTheScanThatSawThem) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    // one key is dispatched per scan, so b and shift wait for later ones
+    press_key(0, 0);
+    press_key(1, 0);
+    press_key(3, 0);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    const latency_stats_t* stats = latency_stats_get();
+    EXPECT_EQ(stats->count, 3);
+    // event times are odd-stamped, so the last key waited 1 or 2 ms
+    EXPECT_GE(stats->max, 1);
+    EXPECT_LE(stats->max, 2);
+    release_key(0, 0);
+    release_key(1, 0);
+    release_key(3, 0);
+    idle_for(3);
+}
+
+TEST_F(LatencyStats, LayerKeyDoesNotLeaveAMeasurementOpen) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(8, 0);
+    run_one_scan_loop();
+    idle_for(50);
+    press_key(0, 0);
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(8, 0);
+    run_one_scan_loop();
+    run_one_scan_loop();
+    const latency_stats_t* stats = latency_stats_get();
+    EXPECT_EQ(stats->buckets[0], 2);
+    EXPECT_EQ(stats->count, 2);
+    EXPECT_EQ(stats->max, 0);
+}
+
+TEST_F(LatencyStats, LongLatenciesAreCountedInTheLastBucket) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    // an event that waited in a queue since it was seen
+    idle_for(200);
+    action_exec((keyevent_t){
+        .key = (keypos_t){ .col = 0, .row = 0 },
+        .pressed = true,
+        .time = (event_time_t)(event_timer_stamp() - 150)
+    });
+    action_exec((keyevent_t){
+        .key = (keypos_t){ .col = 0, .row = 0 },
+        .pressed = false,
+        .time = event_timer_stamp()
+    });
+    const latency_stats_t* stats = latency_stats_get();
+    EXPECT_EQ(stats->buckets[LATENCY_STATS_BUCKETS - 1], 1);
+    EXPECT_EQ(stats->buckets[0], 1);
+    EXPECT_EQ(stats->count, 2);
+    EXPECT_GE(stats->max, 149);
+    EXPECT_LE(stats->max, 151);
+}
+
+TEST_F(LatencyStats, ClearEmptiesTheHistogram) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(0, 0);
+    run_one_scan_loop();
+    latency_stats_clear();
+    const latency_stats_t* stats = latency_stats_get();
+    for (int i = 0; i < LATENCY_STATS_BUCKETS; i++) {
+        EXPECT_EQ(stats->buckets[i], 0);
+    }
+    EXPECT_EQ(stats->count, 0);
+    EXPECT_EQ(stats->max, 0);
+}
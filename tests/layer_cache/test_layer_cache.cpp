@@ -0,0 +1,117 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "test_common.hpp"
+
+extern "C" {
+extern bool remap_c_on_layer_16;
+}
+
+
+class LayerCache : public TestFixture {
+public:
+    void TearDown() override {
+        remap_c_on_layer_16 = false;
+        layer_cache_invalidate();
+        default_layer_set(0);
+    }
+
+    void expect_tap(uint8_t col, uint8_t row, uint8_t keycode) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(keycode)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(testing::AnyNumber());
+        press_key(col, row);
+        run_one_scan_loop();
+        release_key(col, row);
+        run_one_scan_loop();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+
+    /* Average ns per layer_switch_get_layer() over every key position */
+    double lookup_cost(unsigned rounds, bool invalidate) {
+        auto start = std::chrono::steady_clock::now();
+        volatile int8_t sink = 0;
+        for (unsigned i = 0; i < rounds; i++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    if (invalidate) {
+                        layer_cache_invalidate();
+                    }
+                    sink = layer_switch_get_layer((keypos_t){ .col = col, .row = row });
+                }
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        (void)sink;
+        return std::chrono::duration<double, std::nano>(end - start).count() / (rounds * MATRIX_ROWS * MATRIX_COLS);
+    }
+
+    // layer changes send a report
+    testing::NiceMock<TestDriver> driver;
+};
+
+TEST_F(LayerCache, KeysResolveThroughTransparentLayers) {
+    layer_on(16);
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 1);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 1, .row = 0 }), 16);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 2, .row = 0 }), 0);
+}
+
+TEST_F(LayerCache, LayerChangesAreSeenOnTheNextPress) {
+    expect_tap(1, 0, KC_B);
+    layer_on(16);
+    expect_tap(1, 0, KC_F2);
+    layer_off(16);
+    expect_tap(1, 0, KC_B);
+}
+
+TEST_F(LayerCache, DefaultLayerChangesAreSeen) {
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 0);
+    default_layer_set(1UL << 1);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 1);
+    default_layer_set(0);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 0);
+}
+
+TEST_F(LayerCache, DirectLayerStateWritesAreSeen) {
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 1, .row = 0 }), 0);
+    layer_state = 1UL << 16;
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 1, .row = 0 }), 16);
+    layer_state = 0;
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 1, .row = 0 }), 0);
+}
+
+TEST_F(LayerCache, KeymapChangesNeedAnInvalidate) {
+    layer_on(16);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 2, .row = 0 }), 0);
+    remap_c_on_layer_16 = true;
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 2, .row = 0 }), 0);
+    layer_cache_invalidate();
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 2, .row = 0 }), 16);
+}
+
+TEST_F(LayerCache, LookupCostWith32Layers) {
+    layer_state_set(UINT32_MAX);
+    double uncached = lookup_cost(2000, true);
+    double cached = lookup_cost(2000, false);
+    printf("[ BENCH    ] %-20s %8.1f ns/lookup uncached %8.1f ns/lookup cached\n", "32 layers", uncached, cached);
+    RecordProperty("uncached_ns_per_lookup", std::to_string(uncached));
+    RecordProperty("cached_ns_per_lookup", std::to_string(cached));
+    EXPECT_LT(cached, uncached);
+}
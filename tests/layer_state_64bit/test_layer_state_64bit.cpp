@@ -0,0 +1,69 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+class LayerState64Bit : public TestFixture {
+public:
+    void TearDown() override {
+        layer_clear();
+        default_layer_set(0);
+    }
+
+    // layer changes send a report
+    testing::NiceMock<TestDriver> driver;
+};
+
+TEST_F(LayerState64Bit, StateHoldsSixtyFourLayers) {
+    EXPECT_EQ(sizeof(layer_state_t), 8u);
+    EXPECT_EQ(MAX_LAYER, 64);
+    EXPECT_EQ(get_highest_layer(0), 0);
+    EXPECT_EQ(get_highest_layer(1), 0);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 31 | 1), 31);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 32 | (layer_state_t)1 << 31), 32);
+    EXPECT_EQ(get_highest_layer((layer_state_t)1 << 63), 63);
+}
+
+TEST_F(LayerState64Bit, TopLayerWinsAboveThirtyTwo) {
+    layer_on(33);
+    layer_on(40);
+    EXPECT_TRUE(layer_state_is(40));
+    EXPECT_TRUE(IS_LAYER_ON(33));
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 40);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 1, .row = 0 }), 33);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 2, .row = 0 }), 0);
+    layer_off(40);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 0);
+}
+
+TEST_F(LayerState64Bit, KeyOnLayerAboveThirtyTwoIsSent) {
+    // Layer action codes only encode layers 0-31, higher ones are set from code
+    layer_on(40);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F2)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerState64Bit, TriLayerAboveThirtyTwo) {
+    layer_state_t state = (layer_state_t)1 << 33 | (layer_state_t)1 << 40;
+    EXPECT_EQ(update_tri_layer_state(state, 33, 40, 50), state | (layer_state_t)1 << 50);
+    EXPECT_EQ(update_tri_layer_state(state | (layer_state_t)1 << 50, 33, 41, 50), state);
+}
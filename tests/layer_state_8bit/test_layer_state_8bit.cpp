@@ -0,0 +1,66 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerState8Bit : public TestFixture {
+public:
+    void TearDown() override {
+        layer_clear();
+        default_layer_set(0);
+    }
+
+    // layer changes send a report
+    testing::NiceMock<TestDriver> driver;
+};
+
+TEST_F(LayerState8Bit, StateHoldsEightLayers) {
+    EXPECT_EQ(sizeof(layer_state_t), 1u);
+    EXPECT_EQ(MAX_LAYER, 8);
+    EXPECT_EQ(get_highest_layer(0), 0);
+    EXPECT_EQ(get_highest_layer(0x01), 0);
+    EXPECT_EQ(get_highest_layer(0x12), 4);
+    EXPECT_EQ(get_highest_layer(0x80), 7);
+}
+
+TEST_F(LayerState8Bit, TopLayerWins) {
+    layer_on(1);
+    layer_on(7);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 7);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 1, .row = 0 }), 1);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 2, .row = 0 }), 0);
+    layer_invert(7);
+    EXPECT_EQ(layer_state, 0x02);
+}
+
+TEST_F(LayerState8Bit, MomentaryTopLayer) {
+    InSequence s;
+    press_key(0, 3);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_F2)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(testing::AnyNumber());
+    run_one_scan_loop();
+    EXPECT_FALSE(layer_state_is(7));
+}
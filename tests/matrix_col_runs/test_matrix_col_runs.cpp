@@ -0,0 +1,182 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+
+extern "C" {
+#include "matrix_col_runs.h"
+}
+
+// pins as in MATRIX_COL_PINS, on three made up ports
+#define PB(bit) (0x30 | (bit))
+#define PD(bit) (0x90 | (bit))
+#define PF(bit) (0xF0 | (bit))
+
+// the port registers, as volatile as the real ones; keys pull their bit low
+static volatile uint8_t io[16];
+
+// the per-pin loop that col_runs replaces
+static matrix_row_t read_each_pin(const uint8_t* pins) {
+    matrix_row_t row = 0;
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        uint8_t pin = pins[x];
+        row |= (io[pin >> 4] & (1 << (pin & 0xF))) ? 0 : ((matrix_row_t)1 << x);
+    }
+    return row;
+}
+
+static matrix_row_t read_runs(const col_runs_t* runs) {
+    uint8_t port_values[MATRIX_COLS];
+    for (uint8_t p = 0; p < runs->port_count; p++) {
+        port_values[p] = ~io[runs->ports[p]];
+    }
+    return col_runs_gather(runs, port_values);
+}
+
+// the read matrix.c does, with the strategy col_runs_build picked
+static matrix_row_t read_chosen(const uint8_t* pins, const col_runs_t* runs) {
+    return runs->per_pin ? read_each_pin(pins) : read_runs(runs);
+}
+
+// a ProMicro-like board: runs of ascending pins broken up across ports
+static const uint8_t mixed_pins[MATRIX_COLS] = {
+    PF(4), PF(5), PF(6), PF(7), PB(1), PB(3), PB(2), PB(6),
+    PD(0), PD(1), PD(2), PD(3), PD(4), PD(5), PD(6), PD(7),
+    PB(0), PB(4), PB(5), PF(0), PF(1), PB(7), PF(2), PF(3),
+};
+
+// every column on ascending bits
+static const uint8_t ascending_pins[MATRIX_COLS] = {
+    PB(0), PB(1), PB(2), PB(3), PB(4), PB(5), PB(6), PB(7),
+    PD(0), PD(1), PD(2), PD(3), PD(4), PD(5), PD(6), PD(7),
+    PF(0), PF(1), PF(2), PF(3), PF(4), PF(5), PF(6), PF(7),
+};
+
+// every column on descending bits
+static const uint8_t descending_pins[MATRIX_COLS] = {
+    PB(7), PB(6), PB(5), PB(4), PB(3), PB(2), PB(1), PB(0),
+    PD(7), PD(6), PD(5), PD(4), PD(3), PD(2), PD(1), PD(0),
+    PF(7), PF(6), PF(5), PF(4), PF(3), PF(2), PF(1), PF(0),
+};
+
+class MatrixColRuns : public testing::Test {
+public:
+    void SetUp() override {
+        for (auto& port : io) port = 0xFF;
+    }
+
+    // the rows of both readers agree for every single key and some chords
+    void expect_rows_match(const uint8_t* pins) {
+        col_runs_t runs;
+        col_runs_build(&runs, pins, MATRIX_COLS);
+        EXPECT_EQ(read_runs(&runs), read_each_pin(pins));
+        for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+            SetUp();
+            io[pins[x] >> 4] &= ~(1 << (pins[x] & 0xF));
+            EXPECT_EQ(read_runs(&runs), (matrix_row_t)1 << x) << "column " << (int)x;
+        }
+        uint32_t state = 1;
+        for (int i = 0; i < 1000; i++) {
+            for (uint8_t p : {0x3, 0x9, 0xF}) {
+                state = state * 1103515245 + 12345;
+                io[p] = state >> 16;
+            }
+            EXPECT_EQ(read_runs(&runs), read_each_pin(pins));
+        }
+    }
+
+    double time_rows(matrix_row_t (*read)(const uint8_t*, const col_runs_t*), const uint8_t* pins) {
+        col_runs_t runs;
+        col_runs_build(&runs, pins, MATRIX_COLS);
+        volatile matrix_row_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < COL_RUNS_BENCH_ITERATIONS; i++) {
+            sink = sink ^ read(pins, &runs);
+        }
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / (double)COL_RUNS_BENCH_ITERATIONS;
+    }
+
+    void bench(const char* name, const uint8_t* pins) {
+        double each_pin = time_rows([](const uint8_t* p, const col_runs_t*) { return read_each_pin(p); }, pins);
+        double runs = time_rows([](const uint8_t*, const col_runs_t* r) { return read_runs(r); }, pins);
+        double chosen = time_rows(read_chosen, pins);
+        std::printf("[ BENCH    ] %-16s %10.1f ns/row each pin %10.1f ns/row runs %10.1f ns/row chosen\n", name, each_pin, runs, chosen);
+        RecordProperty(std::string(name) + "_each_pin_ns_per_row_x10", static_cast<int>(each_pin * 10));
+        RecordProperty(std::string(name) + "_runs_ns_per_row_x10", static_cast<int>(runs * 10));
+        RecordProperty(std::string(name) + "_chosen_ns_per_row_x10", static_cast<int>(chosen * 10));
+    }
+};
+
+TEST_F(MatrixColRuns, AscendingPinsOfAPortAreOneRun) {
+    col_runs_t runs;
+    col_runs_build(&runs, ascending_pins, MATRIX_COLS);
+    ASSERT_EQ(runs.port_count, 3);
+    ASSERT_EQ(runs.run_count, 3);
+    for (uint8_t i = 0; i < 3; i++) {
+        EXPECT_EQ(runs.runs[i].port, i);
+        EXPECT_EQ(runs.runs[i].mask, 0xFF);
+        EXPECT_EQ(runs.runs[i].shift, 8 * i);
+    }
+}
+
+TEST_F(MatrixColRuns, PinsWithTheSameShiftShareARun) {
+    // columns 0-2 and 5-7 are both on port B at shift 0, with port D between
+    static const uint8_t pins[MATRIX_COLS] = {
+        PB(0), PB(1), PB(2), PD(7), PD(6), PB(5), PB(6), PB(7),
+    };
+    col_runs_t runs;
+    col_runs_build(&runs, pins, 8);
+    ASSERT_EQ(runs.port_count, 2);
+    ASSERT_EQ(runs.run_count, 3);
+    EXPECT_EQ(runs.runs[0].mask, 0xE7);
+    EXPECT_EQ(runs.runs[0].shift, 0);
+    EXPECT_EQ(runs.runs[1].mask, 1 << 7);
+    EXPECT_EQ(runs.runs[1].shift, 3 - 7);
+    EXPECT_EQ(runs.runs[2].mask, 1 << 6);
+    EXPECT_EQ(runs.runs[2].shift, 4 - 6);
+}
+
+TEST_F(MatrixColRuns, DescendingPinsAreARunEach) {
+    col_runs_t runs;
+    col_runs_build(&runs, descending_pins, MATRIX_COLS);
+    EXPECT_EQ(runs.port_count, 3);
+    EXPECT_EQ(runs.run_count, MATRIX_COLS);
+}
+
+TEST_F(MatrixColRuns, RunsAreOnlyUsedWhenTheySaveReads) {
+    col_runs_t runs;
+    col_runs_build(&runs, ascending_pins, MATRIX_COLS);
+    EXPECT_FALSE(runs.per_pin);
+    col_runs_build(&runs, mixed_pins, MATRIX_COLS);
+    EXPECT_FALSE(runs.per_pin);
+    col_runs_build(&runs, descending_pins, MATRIX_COLS);
+    EXPECT_TRUE(runs.per_pin);
+}
+
+TEST_F(MatrixColRuns, RowsMatchReadingEachPin) {
+    expect_rows_match(ascending_pins);
+    expect_rows_match(descending_pins);
+    expect_rows_match(mixed_pins);
+}
+
+TEST_F(MatrixColRuns, Bench) {
+    bench("ascending", ascending_pins);
+    bench("mixed", mixed_pins);
+    bench("descending", descending_pins);
+}
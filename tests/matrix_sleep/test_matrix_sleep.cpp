@@ -0,0 +1,170 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix_sleep.h"
+    void set_time(uint32_t t);
+    void advance_time(uint32_t ms);
+}
+
+/* Host model of the sleeping matrix: the hooks park the rows and "enable"
+ * the pin-change interrupt, and a key press on a parked matrix raises it.
+ */
+namespace {
+struct SimulatedMatrix {
+    bool wakeup_supported = true;
+    bool parked = false;
+    unsigned keys_down = 0;
+    unsigned full_scans = 0;
+    unsigned skipped_scans = 0;
+    unsigned arms = 0;
+    unsigned waits = 0;
+
+    void press() {
+        keys_down++;
+        if (parked) {
+            matrix_sleep_wake();
+        }
+    }
+
+    void release() {
+        keys_down--;
+    }
+
+    // one pass of the main loop, with the same calls as quantum/matrix.c
+    void scan() {
+        if (matrix_sleep_scan_begin()) {
+            full_scans++;
+            matrix_sleep_scan_end(keys_down > 0);
+        } else {
+            skipped_scans++;
+        }
+        advance_time(1);
+    }
+
+    void scan_for(unsigned ms) {
+        for (unsigned i = 0; i < ms; i++) {
+            scan();
+        }
+    }
+};
+
+SimulatedMatrix* sim;
+}
+
+extern "C" {
+bool matrix_sleep_arm(void) {
+    if (!sim->wakeup_supported) {
+        return false;
+    }
+    sim->arms++;
+    sim->parked = true;
+    if (sim->keys_down) {
+        matrix_sleep_wake();
+    }
+    return true;
+}
+
+void matrix_sleep_wait(void) {
+    sim->waits++;
+}
+
+void matrix_sleep_disarm(void) {
+    sim->parked = false;
+}
+}
+
+class MatrixSleep : public testing::Test {
+public:
+    void SetUp() override {
+        sim = &matrix;
+        set_time(0);
+        matrix_sleep_init();
+    }
+
+    SimulatedMatrix matrix;
+};
+
+TEST_F(MatrixSleep, ScansFullyDuringTheBurst) {
+    matrix.scan_for(MATRIX_SLEEP_BURST);
+    EXPECT_EQ(matrix.full_scans, MATRIX_SLEEP_BURST);
+    EXPECT_EQ(matrix.skipped_scans, 0u);
+    EXPECT_FALSE(matrix_sleep_is_asleep());
+}
+
+TEST_F(MatrixSleep, SleepsWhenIdleAfterTheBurst) {
+    matrix.scan_for(MATRIX_SLEEP_BURST + 2);
+    EXPECT_TRUE(matrix_sleep_is_asleep());
+    unsigned full_scans = matrix.full_scans;
+    matrix.scan_for(1000);
+    EXPECT_EQ(matrix.full_scans, full_scans);
+    EXPECT_EQ(matrix.arms, 1u);
+    EXPECT_EQ(matrix.waits, 1000u);
+    EXPECT_TRUE(matrix.parked);
+}
+
+TEST_F(MatrixSleep, PinChangeWakesTheMatrix) {
+    matrix.scan_for(MATRIX_SLEEP_BURST + 100);
+    ASSERT_TRUE(matrix.parked);
+    unsigned full_scans = matrix.full_scans;
+    matrix.press();
+    matrix.scan();
+    EXPECT_EQ(matrix.full_scans, full_scans + 1);
+    EXPECT_FALSE(matrix.parked);
+    EXPECT_FALSE(matrix_sleep_is_asleep());
+}
+
+TEST_F(MatrixSleep, HeldKeyKeepsTheMatrixAwake) {
+    matrix.press();
+    matrix.scan_for(MATRIX_SLEEP_BURST * 10);
+    EXPECT_FALSE(matrix_sleep_is_asleep());
+    EXPECT_EQ(matrix.skipped_scans, 0u);
+    EXPECT_EQ(matrix.arms, 0u);
+}
+
+TEST_F(MatrixSleep, BurstRestartsAfterTheLastRelease) {
+    matrix.scan_for(MATRIX_SLEEP_BURST + 100);
+    matrix.press();
+    matrix.scan_for(20);
+    matrix.release();
+    unsigned full_scans = matrix.full_scans;
+    matrix.scan_for(MATRIX_SLEEP_BURST);
+    EXPECT_EQ(matrix.full_scans, full_scans + MATRIX_SLEEP_BURST);
+    matrix.scan_for(100);
+    EXPECT_TRUE(matrix_sleep_is_asleep());
+    EXPECT_EQ(matrix.arms, 2u);
+}
+
+TEST_F(MatrixSleep, PressBeforeArmingIsNotLost) {
+    matrix.scan_for(MATRIX_SLEEP_BURST + 2);
+    ASSERT_TRUE(matrix_sleep_is_asleep());
+    ASSERT_FALSE(matrix.parked);
+    // the key goes down before the rows are parked, so no interrupt fires
+    matrix.press();
+    unsigned full_scans = matrix.full_scans;
+    matrix.scan();
+    EXPECT_EQ(matrix.full_scans, full_scans + 1);
+    EXPECT_FALSE(matrix_sleep_is_asleep());
+}
+
+TEST_F(MatrixSleep, ScansWhenWakeupIsNotSupported) {
+    matrix.wakeup_supported = false;
+    matrix.scan_for(MATRIX_SLEEP_BURST * 10);
+    EXPECT_EQ(matrix.full_scans, MATRIX_SLEEP_BURST * 10u);
+    EXPECT_EQ(matrix.skipped_scans, 0u);
+}
@@ -0,0 +1,36 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_Q, KC_W, KC_E, KC_R, KC_Z},
+        {KC_A, KC_S, KC_D, MO(1), KC_NO},
+    },
+    [1] = {
+        {KC_1, KC_2, KC_3, KC_4, KC_5},
+        {KC_6, KC_7, KC_8, KC_TRNS, KC_NO},
+    },
+};
+
+const keypos_t PROGMEM qw_combo[] = {COMBO_POS(0, 1), COMBO_POS(0, 0), COMBO_POS_END};
+const keypos_t PROGMEM asd_combo[] = {COMBO_POS(1, 0), COMBO_POS(1, 1), COMBO_POS(1, 2), COMBO_POS_END};
+
+const positional_combo_t PROGMEM positional_combos[POSITIONAL_COMBO_COUNT] = {
+    POSITIONAL_COMBO(qw_combo, KC_ESC),
+    POSITIONAL_COMBO(asd_combo, KC_ENT),
+};
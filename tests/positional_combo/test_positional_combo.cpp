@@ -0,0 +1,179 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class PositionalCombo : public TestFixture {};
+
+TEST_F(PositionalCombo, NonComboKeyIsNotHeldBack) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(PositionalCombo, TwoKeyComboFires) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(PositionalCombo, ComboFiresOnAnyLayer) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(3, 1);
+    run_one_scan_loop();
+    press_key(1, 0);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    release_key(3, 1);
+    run_one_scan_loop();
+}
+
+TEST_F(PositionalCombo, ThreeKeyCombo) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 1);
+    run_one_scan_loop();
+    press_key(2, 1);
+    run_one_scan_loop();
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ENT)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    release_key(1, 1);
+    release_key(2, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(3);
+}
+
+TEST_F(PositionalCombo, LoneTapIsReplayedOnRelease) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(PositionalCombo, HeldKeyIsReplayedAfterComboTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(COMBO_TERM - 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // one scan of slack for the odd event time stamp
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    idle_for(2);
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(PositionalCombo, KeyOutsideComboReplaysHeldKeys) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q, KC_E)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+}
+
+TEST_F(PositionalCombo, KeyInTheSameScanWaitsForTheReplay) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    run_one_scan_loop();
+    // the release of q is seen first and replays q; z must not overtake it
+    release_key(0, 0);
+    press_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Q)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(PositionalCombo, ComboKeyInTheSameScanIsMatchedAfterTheReplay) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 1);
+    run_one_scan_loop();
+    // z replays a, then s waits behind it and is held back on its own
+    press_key(4, 0);
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_Z)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_Z, KC_S)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_Z)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
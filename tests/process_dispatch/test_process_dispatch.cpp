@@ -0,0 +1,122 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <cstdio>
+
+using testing::_;
+using testing::AnyNumber;
+using testing::AtLeast;
+using testing::InSequence;
+
+// The handler chain as it was before the dispatch table, for the benchmark
+static bool process_every_handler(uint16_t keycode, keyrecord_t *record) {
+    return process_record_kb(keycode, record) &&
+        process_tap_dance(keycode, record) &&
+        process_leader(keycode, record) &&
+        process_combo(keycode, record) &&
+        process_unicode(keycode, record) &&
+        process_auto_shift(keycode, record) &&
+        true;
+}
+
+class ProcessDispatch : public TestFixture {
+public:
+    // ns per press or release of keycode through process
+    double time_key(bool (*process)(uint16_t, keyrecord_t*), uint16_t keycode) {
+        keyrecord_t record = {};
+        record.event.key = (keypos_t){ .col = 0, .row = 0 };
+        record.event.time = 1;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < DISPATCH_BENCH_ITERATIONS; i++) {
+            record.event.pressed = true;
+            process(keycode, &record);
+            record.event.pressed = false;
+            process(keycode, &record);
+        }
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / (2.0 * DISPATCH_BENCH_ITERATIONS);
+    }
+};
+
+TEST_F(ProcessDispatch, PlainKeyPassesThrough) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LEFT)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(ProcessDispatch, TapDanceKeyReachesTapDance) {
+    TestDriver driver;
+    InSequence s;
+
+    // the second tap completes the pair
+    press_key(2, 0);
+    run_one_scan_loop();
+    release_key(2, 0);
+    run_one_scan_loop();
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Y)));
+    run_one_scan_loop();
+    // a dance without mods sends nothing more when it finishes or resets
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(TAPPING_TERM + 1);
+}
+
+TEST_F(ProcessDispatch, ComboKeysReachCombo) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 1);
+    run_one_scan_loop();
+    press_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    release_key(1, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+}
+
+TEST_F(ProcessDispatch, UnicodeKeyReachesUnicode) {
+    testing::NiceMock<TestDriver> driver;
+
+    // the default input mode holds left alt while typing the hex code
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_E))).Times(AtLeast(1));
+    press_key(3, 0);
+    run_one_scan_loop();
+    release_key(3, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(ProcessDispatch, Bench) {
+    testing::NiceMock<TestDriver> driver;
+
+    double every = time_key(process_every_handler, KC_LEFT);
+    double dispatched = time_key(process_record_processors, KC_LEFT);
+    std::printf("[ BENCH    ] %-16s %10.1f ns/key every handler %10.1f ns/key dispatched\n",
+        "plain key", every, dispatched);
+    RecordProperty("every_handler_ns_per_key_x10", static_cast<int>(every * 10));
+    RecordProperty("dispatched_ns_per_key_x10", static_cast<int>(dispatched * 10));
+}
@@ -0,0 +1,123 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "profile.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class Profile : public TestFixture {
+public:
+    Profile() {
+        profile_clear();
+    }
+};
+
+TEST_F(Profile, EveryScanIsCounted) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+    EXPECT_EQ(profile_get(PROFILE_MATRIX_SCAN)->count, 10);
+    EXPECT_EQ(profile_get(PROFILE_MATRIX_SCAN_KB)->count, 10);
+    EXPECT_EQ(profile_get(PROFILE_ACTION_EXEC)->count, 10);
+    EXPECT_EQ(profile_get(PROFILE_LED)->count, 10);
+}
+
+TEST_F(Profile, MinMeanAndMaxAreTracked) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(1, 0);
+    run_one_scan_loop();
+    const profile_stat_t* stat = profile_get(PROFILE_ACTION_EXEC);
+    EXPECT_EQ(stat->count, 1);
+    EXPECT_EQ(stat->min, 3);
+    EXPECT_EQ(stat->max, 3);
+    EXPECT_EQ(stat->total, 3);
+
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(stat->count, 2);
+    EXPECT_EQ(stat->min, 0);
+    EXPECT_EQ(stat->max, 3);
+    EXPECT_EQ(stat->total, 3);
+}
+
+TEST_F(Profile, ProcessorsAreTimedPerKey) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(1, 0);
+    run_one_scan_loop();
+    release_key(1, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(profile_get(PROFILE_PROCESS_RECORD)->count, 2);
+    EXPECT_EQ(profile_get(PROFILE_PROCESS_RECORD_KB)->count, 2);
+    EXPECT_EQ(profile_get(PROFILE_PROCESS_LEADER)->count, 2);
+    // ticks do not reach the processors
+    idle_for(5);
+    EXPECT_EQ(profile_get(PROFILE_PROCESS_RECORD)->count, 2);
+}
+
+TEST_F(Profile, SlowUserCodeCountsToProcessRecordKb) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(1, 0);
+    run_one_scan_loop();
+    // a keyboard may replace the weak process_record_kb, so the user code
+    // is only timed as part of it
+    const profile_stat_t* kb = profile_get(PROFILE_PROCESS_RECORD_KB);
+    EXPECT_EQ(kb->count, 1);
+    EXPECT_EQ(kb->max, 3);
+    EXPECT_EQ(kb->total, 3);
+    EXPECT_EQ(profile_get(PROFILE_PROCESS_RECORD)->max, 3);
+    EXPECT_EQ(profile_get(PROFILE_PROCESS_LEADER)->max, 0);
+    release_key(1, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(Profile, NestedStageIsTimedFromItsOutermostStart) {
+    profile_start(PROFILE_MIDI);
+    advance_time(2);
+    profile_start(PROFILE_MIDI);
+    advance_time(3);
+    profile_stop(PROFILE_MIDI);
+    advance_time(1);
+    profile_stop(PROFILE_MIDI);
+    const profile_stat_t* stat = profile_get(PROFILE_MIDI);
+    EXPECT_EQ(stat->count, 1);
+    EXPECT_EQ(stat->total, 6);
+    // a stop without a start is ignored
+    profile_stop(PROFILE_MIDI);
+    EXPECT_EQ(stat->count, 1);
+}
+
+TEST_F(Profile, ClearResetsAllStages) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    press_key(1, 0);
+    run_one_scan_loop();
+    profile_clear();
+    for (int i = 0; i < PROFILE_STAGES; i++) {
+        const profile_stat_t* stat = profile_get(static_cast<profile_stage_t>(i));
+        EXPECT_EQ(stat->count, 0);
+        EXPECT_EQ(stat->total, 0);
+        EXPECT_EQ(stat->max, 0);
+    }
+}
@@ -0,0 +1,58 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+class SourceLayersCache16Bit : public TestFixture {
+public:
+    testing::NiceMock<TestDriver> driver;
+};
+
+TEST_F(SourceLayersCache16Bit, EveryKeyKeepsItsOwnLayer) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            update_source_layers_cache((keypos_t){ .col = col, .row = row }, (row * MATRIX_COLS + col) % 16);
+        }
+    }
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            EXPECT_EQ(read_source_layers_cache((keypos_t){ .col = col, .row = row }), (row * MATRIX_COLS + col) % 16);
+        }
+    }
+    for (uint8_t layer = 0; layer < 16; layer++) {
+        update_source_layers_cache((keypos_t){ .col = 5, .row = 1 }, layer);
+        EXPECT_EQ(read_source_layers_cache((keypos_t){ .col = 5, .row = 1 }), layer);
+        EXPECT_EQ(read_source_layers_cache((keypos_t){ .col = 4, .row = 1 }), 14u % 16);
+        EXPECT_EQ(read_source_layers_cache((keypos_t){ .col = 6, .row = 1 }), 16u % 16);
+    }
+}
+
+TEST_F(SourceLayersCache16Bit, ReleaseUsesTheLayerOfThePress) {
+    testing::InSequence s;
+    press_key(0, 3);
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    // turning the layer off resends the held modifier
+    release_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT))).Times(testing::AnyNumber());
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
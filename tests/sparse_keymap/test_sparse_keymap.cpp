@@ -0,0 +1,79 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+extern const uint16_t dense_keymaps[][MATRIX_ROWS][MATRIX_COLS];
+}
+
+class SparseKeymap : public TestFixture {
+public:
+    void TearDown() override {
+        layer_clear();
+    }
+
+    void expect_tap(uint8_t col, uint8_t row, uint8_t keycode) {
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(keycode)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(testing::AnyNumber());
+        press_key(col, row);
+        run_one_scan_loop();
+        release_key(col, row);
+        run_one_scan_loop();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+
+    // layer changes send a report
+    testing::NiceMock<TestDriver> driver;
+};
+
+TEST_F(SparseKeymap, SparseLayersMatchTheirDenseForm) {
+    for (uint8_t layer = 1; layer <= 2; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                EXPECT_EQ(keymap_key_to_keycode(layer, (keypos_t){ .col = col, .row = row }), dense_keymaps[layer][row][col])
+                    << "layer " << +layer << " row " << +row << " col " << +col;
+            }
+        }
+    }
+}
+
+TEST_F(SparseKeymap, DenseLayersAreReadFromKeymaps) {
+    EXPECT_EQ(keymap_key_to_keycode(0, (keypos_t){ .col = 0, .row = 0 }), KC_A);
+    EXPECT_EQ(keymap_key_to_keycode(3, (keypos_t){ .col = 9, .row = 3 }), KC_ENT);
+    EXPECT_EQ(keymap_key_to_keycode(3, (keypos_t){ .col = 0, .row = 0 }), KC_TRNS);
+}
+
+TEST_F(SparseKeymap, LayerResolutionFallsThroughSparseLayers) {
+    layer_on(1);
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 0 }), 1);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 1 }), 2);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 4, .row = 0 }), 0);
+    layer_on(3);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 9, .row = 3 }), 3);
+    EXPECT_EQ(layer_switch_get_layer((keypos_t){ .col = 0, .row = 2 }), 2);
+}
+
+TEST_F(SparseKeymap, KeysOnSparseLayersAreSent) {
+    press_key(0, 3);
+    run_one_scan_loop();
+    expect_tap(9, 0, KC_F10);
+    expect_tap(5, 0, KC_F);
+    release_key(0, 3);
+    run_one_scan_loop();
+    expect_tap(9, 0, KC_J);
+}
@@ -0,0 +1,40 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A},
+    },
+};
+
+#define K(row, col) SPARSE_KEY(row, col, LARGE_LAYER_KEYCODE(row, col))
+#define ROW(r) \
+    K(r, 0),  K(r, 1),  K(r, 2),  K(r, 3),  K(r, 4),  K(r, 5),  K(r, 6),  K(r, 7),  K(r, 8),  K(r, 9), \
+    K(r, 10), K(r, 11), K(r, 12), K(r, 13), K(r, 14), K(r, 15), K(r, 16), K(r, 17), K(r, 18), K(r, 19)
+
+// every key but the last, more than a uint8_t can count
+const sparse_key_t PROGMEM large_layer[] = {
+    ROW(0),  ROW(1),  ROW(2),  ROW(3),  ROW(4),  ROW(5),  ROW(6),  ROW(7),
+    ROW(8),  ROW(9),  ROW(10), ROW(11), ROW(12), ROW(13), ROW(14),
+    K(15, 0),  K(15, 1),  K(15, 2),  K(15, 3),  K(15, 4),  K(15, 5),  K(15, 6),  K(15, 7),  K(15, 8),  K(15, 9),
+    K(15, 10), K(15, 11), K(15, 12), K(15, 13), K(15, 14), K(15, 15), K(15, 16), K(15, 17), K(15, 18),
+};
+
+SPARSE_KEYMAPS(
+    [1] = SPARSE_LAYER(large_layer),
+);
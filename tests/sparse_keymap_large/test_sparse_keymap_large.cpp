@@ -0,0 +1,30 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+class SparseKeymapLarge : public TestFixture {};
+
+TEST_F(SparseKeymapLarge, EveryKeyOfALayerWithMoreThan255Keys) {
+    EXPECT_EQ(pgm_read_word(&sparse_keymaps[1].count), MATRIX_ROWS * MATRIX_COLS - 1);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint16_t expected = row == MATRIX_ROWS - 1 && col == MATRIX_COLS - 1 ? KC_TRNS : LARGE_LAYER_KEYCODE(row, col);
+            EXPECT_EQ(keymap_key_to_keycode(1, (keypos_t){ .col = col, .row = row }), expected)
+                << "row " << +row << " col " << +col;
+        }
+    }
+}
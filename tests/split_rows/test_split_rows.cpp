@@ -0,0 +1,85 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <cstring>
+
+extern "C" {
+#include "split_common/i2c.h"
+#include "split_common/serial.h"
+}
+
+// the I2C slave buffer, with the backlight and RGB bytes in front of the rows
+class SplitRows : public testing::Test {
+public:
+    void SetUp() override {
+        std::memset(const_cast<uint8_t*>(buffer), 0xAA, sizeof(buffer));
+        for (auto& row : rows) row = 0;
+    }
+
+    // pack rows into the buffer and back into other_rows
+    void round_trip() {
+        split_rows_pack(&buffer[I2C_KEYMAP_START], rows);
+        for (uint8_t i = 0; i < I2C_KEYMAP_START; i++) {
+            EXPECT_EQ(buffer[i], 0xAA) << "byte " << (int)i;
+        }
+        split_rows_unpack(other_rows, &buffer[I2C_KEYMAP_START]);
+        for (uint8_t r = 0; r < ROWS_PER_HAND; r++) {
+            EXPECT_EQ(other_rows[r], rows[r]) << "row " << (int)r;
+        }
+    }
+
+    volatile uint8_t buffer[SLAVE_BUFFER_SIZE];
+    matrix_row_t rows[ROWS_PER_HAND];
+    matrix_row_t other_rows[ROWS_PER_HAND];
+};
+
+TEST_F(SplitRows, BuffersHoldAHalf) {
+    EXPECT_EQ(sizeof(matrix_row_t), SPLIT_ROWS_ROW_BYTES);
+    EXPECT_EQ(HALF_MATRIX_BYTES, ROWS_PER_HAND * SPLIT_ROWS_ROW_BYTES);
+    EXPECT_EQ(SLAVE_BUFFER_SIZE, I2C_KEYMAP_START + ROWS_PER_HAND * SPLIT_ROWS_ROW_BYTES);
+    EXPECT_EQ(SERIAL_SLAVE_BUFFER_LENGTH, ROWS_PER_HAND * SPLIT_ROWS_ROW_BYTES);
+}
+
+TEST_F(SplitRows, EachKeyIsSentInItsByte) {
+    for (uint8_t r = 0; r < ROWS_PER_HAND; r++) {
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            SetUp();
+            rows[r] = (matrix_row_t)1 << c;
+            round_trip();
+            for (uint8_t i = 0; i < HALF_MATRIX_BYTES; i++) {
+                uint8_t expected = i == r * SPLIT_ROWS_ROW_BYTES + c / 8 ? 1 << (c % 8) : 0;
+                EXPECT_EQ(buffer[I2C_KEYMAP_START + i], expected) << "row " << (int)r << " column " << (int)c;
+            }
+        }
+    }
+}
+
+TEST_F(SplitRows, AllKeysOfAHalf) {
+    for (auto& row : rows) row = ((matrix_row_t)1 << (MATRIX_COLS - 1) << 1) - 1;
+    round_trip();
+}
+
+TEST_F(SplitRows, RowsAreUnpackedInOrder) {
+    uint32_t state = 1;
+    for (int i = 0; i < 1000; i++) {
+        for (auto& row : rows) {
+            state = state * 1103515245 + 12345;
+            row = (matrix_row_t)(state >> 8) & (((matrix_row_t)1 << (MATRIX_COLS - 1) << 1) - 1);
+        }
+        round_trip();
+    }
+}
@@ -0,0 +1,26 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_SPLIT_ROWS_WIDE_CONFIG_H_
+#define TESTS_SPLIT_ROWS_WIDE_CONFIG_H_
+
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 24
+
+// more than 16 columns, four bytes per row
+#define SPLIT_ROWS_ROW_BYTES 4
+
+#endif /* TESTS_SPLIT_ROWS_WIDE_CONFIG_H_ */
@@ -0,0 +1,31 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_TAPPING_FUZZ_CONFIG_H_
+#define TESTS_TAPPING_FUZZ_CONFIG_H_
+
+#define MATRIX_ROWS 2
+#define MATRIX_COLS 8
+
+// layer 1 remaps a mod-tap, so its release must go to the layer it was pressed on
+#define PREVENT_STUCK_MODIFIERS
+
+// sequences per run and key events per sequence; a seed can be replayed with
+// the TAPPING_FUZZ_SEED environment variable
+#define TAPPING_FUZZ_RUNS 200
+#define TAPPING_FUZZ_STEPS 100
+
+#endif /* TESTS_TAPPING_FUZZ_CONFIG_H_ */
@@ -0,0 +1,154 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fuzz.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <sstream>
+#include "keyboard_report_util.hpp"
+
+extern "C" {
+#include "quantum.h"
+    void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::Invoke;
+
+// the keys the fuzzer presses, all on row 0
+#define FUZZ_KEYS 6
+
+// every code the keymap can put in a report
+static const uint8_t fuzz_codes[] = {
+    KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_1, KC_2, KC_3,
+};
+static const uint8_t fuzz_mods = MOD_BIT(KC_LSFT) | MOD_BIT(KC_LCTL) | MOD_BIT(KC_LALT);
+
+// xorshift32, so a seed replays the same sequence everywhere
+static uint32_t fuzz_next(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+FuzzSequence fuzz_sequence(uint32_t seed, unsigned steps) {
+    FuzzSequence sequence;
+    uint32_t state = seed ? seed : 1;
+    uint8_t pressed = 0;
+    for (unsigned i = 0; i < steps; i++) {
+        // mostly rolled typing, sometimes around the tapping term, rarely idle
+        uint32_t r = fuzz_next(&state);
+        uint16_t delay;
+        switch (r % 10) {
+            case 0:
+                delay = TAPPING_TERM + fuzz_next(&state) % (2 * TAPPING_TERM);
+                break;
+            case 1: case 2: case 3:
+                delay = fuzz_next(&state) % (TAPPING_TERM + 50);
+                break;
+            default:
+                delay = fuzz_next(&state) % 40;
+                break;
+        }
+        uint8_t col = fuzz_next(&state) % FUZZ_KEYS;
+        pressed ^= 1 << col;
+        sequence.push_back({delay, col, static_cast<uint8_t>((pressed >> col) & 1)});
+    }
+    for (uint8_t col = 0; col < FUZZ_KEYS; col++) {
+        if (pressed & (1 << col)) {
+            sequence.push_back({static_cast<uint16_t>(fuzz_next(&state) % 40), col, 0});
+        }
+    }
+    return sequence;
+}
+
+static void tick_for(uint16_t ms, FuzzResult& result) {
+    for (uint16_t i = 0; i < ms; i++) {
+        advance_time(1);
+        action_exec(TICK);
+        result.ticks++;
+    }
+}
+
+FuzzResult run_fuzz_sequence(const FuzzSequence& sequence, TestDriver& driver) {
+    FuzzResult result = {};
+    report_keyboard_t last = {};
+    std::ostringstream failure;
+
+    ON_CALL(driver, send_keyboard_mock(_)).WillByDefault(Invoke([&](report_keyboard_t& report) {
+        result.reports++;
+        if (!failure.str().empty()) return;
+        if (result.reports > 1 && report == last) {
+            failure << "duplicate report #" << result.reports << " after event " << result.events << ": " << report;
+        }
+        if (report.mods & ~fuzz_mods) {
+            failure << "unexpected mods in report #" << result.reports << ": " << report;
+        }
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+            uint8_t code = report.keys[i];
+            if (code && std::find(std::begin(fuzz_codes), std::end(fuzz_codes), code) == std::end(fuzz_codes)) {
+                failure << "unexpected code " << (int)code << " in report #" << result.reports << ": " << report;
+                break;
+            }
+        }
+        last = report;
+    }));
+
+    auto start = std::chrono::steady_clock::now();
+    for (const FuzzStep& step : sequence) {
+        tick_for(step.delay, result);
+        action_exec((keyevent_t){
+            .key = (keypos_t){ .col = step.col, .row = 0 },
+            .pressed = static_cast<bool>(step.pressed),
+            .time = event_timer_stamp()
+        });
+        result.events++;
+    }
+    tick_for(2 * TAPPING_TERM, result);
+    auto stop = std::chrono::steady_clock::now();
+    result.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+    if (failure.str().empty()) {
+        if (result.reports && !(last == report_keyboard_t{})) {
+            failure << "stuck keys at quiescence: " << last;
+        } else if (get_mods() || get_weak_mods()) {
+            failure << "stuck mods at quiescence: " << (int)get_mods() << "/" << (int)get_weak_mods();
+        } else if (layer_state) {
+            failure << "stuck layers at quiescence: " << layer_state;
+        } else if (has_anykey(keyboard_report)) {
+            failure << "keys left in the report at quiescence: " << *keyboard_report;
+        }
+    }
+    result.failure = failure.str();
+    // drops the handler, which refers to this frame
+    testing::Mock::VerifyAndClear(&driver);
+    return result;
+}
+
+double FuzzResult::events_per_second() const {
+    return nanoseconds ? events * 1e9 / nanoseconds : 0;
+}
+
+std::string describe_sequence(const FuzzSequence& sequence) {
+    std::ostringstream stream;
+    for (const FuzzStep& step : sequence) {
+        stream << "+" << step.delay << "ms " << (step.pressed ? "press " : "release ") << (int)step.col << "\n";
+    }
+    return stream.str();
+}
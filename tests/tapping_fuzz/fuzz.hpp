@@ -0,0 +1,55 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "test_driver.hpp"
+
+// One generated switch transition, delay ms after the previous one
+struct FuzzStep {
+    uint16_t delay;
+    uint8_t col;
+    uint8_t pressed;
+};
+
+typedef std::vector<FuzzStep> FuzzSequence;
+
+struct FuzzResult {
+    std::string failure; // empty when every invariant held
+    uint32_t events;
+    uint32_t ticks;
+    uint32_t reports;
+    uint64_t nanoseconds;
+
+    double events_per_second() const;
+};
+
+// Builds a random press/release sequence over the keys of row 0. Every key
+// pressed is released again by the end, so the sequence ends quiescent.
+FuzzSequence fuzz_sequence(uint32_t seed, unsigned steps);
+
+// Feeds the sequence through action_exec(), with a TICK for every elapsed
+// millisecond, then checks the reports the driver saw:
+// - no report repeats the previous one
+// - no report contains a code the keymap cannot produce
+// - once every key is released and the tapping term has passed, the last
+//   report is empty and no mods or layers are left on
+FuzzResult run_fuzz_sequence(const FuzzSequence& sequence, TestDriver& driver);
+
+std::string describe_sequence(const FuzzSequence& sequence);
@@ -0,0 +1,71 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "fuzz.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+class TappingFuzz : public TestFixture {
+public:
+    testing::NiceMock<TestDriver> driver;
+
+    // replays one sequence, printing it in full if an invariant breaks
+    bool replay(uint32_t seed, FuzzResult& total) {
+        FuzzSequence sequence = fuzz_sequence(seed, TAPPING_FUZZ_STEPS);
+        FuzzResult result = run_fuzz_sequence(sequence, driver);
+        total.events += result.events;
+        total.ticks += result.ticks;
+        total.reports += result.reports;
+        total.nanoseconds += result.nanoseconds;
+        if (!result.failure.empty()) {
+            ADD_FAILURE() << "seed " << seed << " (replay with TAPPING_FUZZ_SEED=" << seed << "): "
+                          << result.failure << "\n" << describe_sequence(sequence);
+            return false;
+        }
+        return true;
+    }
+};
+
+TEST_F(TappingFuzz, SequencesAreReproducible) {
+    FuzzSequence a = fuzz_sequence(1234, TAPPING_FUZZ_STEPS);
+    FuzzSequence b = fuzz_sequence(1234, TAPPING_FUZZ_STEPS);
+    EXPECT_EQ(describe_sequence(a), describe_sequence(b));
+    EXPECT_NE(describe_sequence(a), describe_sequence(fuzz_sequence(4321, TAPPING_FUZZ_STEPS)));
+
+    // every press is matched by a release
+    uint8_t pressed = 0;
+    for (const FuzzStep& step : a) {
+        EXPECT_EQ(!!(pressed & (1 << step.col)), !step.pressed);
+        pressed ^= 1 << step.col;
+    }
+    EXPECT_EQ(pressed, 0);
+}
+
+TEST_F(TappingFuzz, InvariantsHold) {
+    FuzzResult total = {};
+    const char* replay_seed = std::getenv("TAPPING_FUZZ_SEED");
+    if (replay_seed) {
+        replay(std::strtoul(replay_seed, nullptr, 0), total);
+    } else {
+        for (uint32_t seed = 1; seed <= TAPPING_FUZZ_RUNS; seed++) {
+            if (!replay(seed, total)) break;
+        }
+    }
+    std::printf("[ FUZZ     ] %u events %u ticks %u reports %12.0f events/s\n",
+        total.events, total.ticks, total.reports, total.events_per_second());
+    RecordProperty("events_per_second", static_cast<int>(total.events_per_second()));
+}
@@ -0,0 +1,137 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class TappingPolicy : public TestFixture {};
+
+TEST_F(TappingPolicy, TermsComeFromThePolicyTable) {
+    EXPECT_EQ(get_tapping_term((keypos_t){ .col = 0, .row = 0 }), 120);
+    EXPECT_EQ(get_tapping_term((keypos_t){ .col = 1, .row = 0 }), TAPPING_TERM);
+    EXPECT_EQ(get_tapping_term((keypos_t){ .col = 2, .row = 0 }), 300);
+    EXPECT_EQ(get_tapping_term((keypos_t){ .col = 3, .row = 0 }), TAPPING_TERM);
+    EXPECT_EQ(get_tapping_flags((keypos_t){ .col = 0, .row = 0 }), TAPPING_PERMISSIVE_HOLD);
+    EXPECT_EQ(get_tapping_flags((keypos_t){ .col = 3, .row = 0 }), TAPPING_DEFAULT_FLAGS);
+}
+
+TEST_F(TappingPolicy, ShortTermKeyHoldsEarly) {
+    TestDriver driver;
+    InSequence s;
+
+    // event times are rounded up to odd, so the hold lands on one of two scans
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(119);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    idle_for(2);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TappingPolicy, LongTermKeyStillTapsAfterTheDefaultTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM + 50);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_SPC)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    idle_for(300);
+}
+
+TEST_F(TappingPolicy, PermissiveHoldOnlyForItsKey) {
+    TestDriver driver;
+    InSequence s;
+
+    // permissive: a key typed while held makes it a hold
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(0, 1);
+    run_one_scan_loop();
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_K)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // not permissive: the same roll waits for the tap key to be released
+    press_key(3, 0);
+    run_one_scan_loop();
+    press_key(0, 1);
+    run_one_scan_loop();
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT, KC_K)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+}
+
+TEST_F(TappingPolicy, RetroTappingOnlyForItsKey) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    idle_for(TAPPING_TERM + 1);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_S)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LALT)));
+    idle_for(TAPPING_TERM + 1);
+    release_key(3, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(TappingPolicy, RetroTappingIsCancelledByAnotherKey) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    idle_for(TAPPING_TERM + 1);
+    press_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_K)));
+    run_one_scan_loop();
+    release_key(0, 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
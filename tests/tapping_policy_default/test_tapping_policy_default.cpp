@@ -0,0 +1,41 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class TappingPolicyDefault : public TestFixture {};
+
+TEST_F(TappingPolicyDefault, KeysWithoutATableUseTappingTerm) {
+    EXPECT_EQ(get_tapping_term((keypos_t){ .col = 0, .row = 0 }), TAPPING_TERM);
+    EXPECT_EQ(get_tapping_flags((keypos_t){ .col = 0, .row = 0 }), TAPPING_DEFAULT_FLAGS);
+}
+
+TEST_F(TappingPolicyDefault, TapKeyHoldsAfterTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    idle_for(2);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
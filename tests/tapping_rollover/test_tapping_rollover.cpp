@@ -0,0 +1,96 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <set>
+#include "test_common.hpp"
+extern "C" {
+#include "action_tapping.h"
+}
+
+using testing::_;
+using testing::Invoke;
+
+class TappingRollover : public TestFixture {
+public:
+    void SetUp() override {
+        waiting_buffer_clear_stats();
+        ON_CALL(driver, send_keyboard_mock(_)).WillByDefault(Invoke([this](report_keyboard_t& report) {
+            for (unsigned i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                if (report.keys[i]) {
+                    sent_keys.insert(report.keys[i]);
+                    if (report.mods & MOD_BIT(KC_LSFT)) {
+                        shifted_keys.insert(report.keys[i]);
+                    }
+                }
+            }
+        }));
+    }
+
+    /* Rolls over the 12 keys K..V, each pressed before the previous one is released */
+    void roll_twelve_keys() {
+        for (uint8_t i = 0; i < 12; i++) {
+            press_key(i % 10, 1 + i / 10);
+            run_one_scan_loop();
+            if (i > 0) {
+                release_key((i - 1) % 10, 1 + (i - 1) / 10);
+                run_one_scan_loop();
+            }
+        }
+        release_key(11 % 10, 1 + 11 / 10);
+        run_one_scan_loop();
+    }
+
+    testing::NiceMock<TestDriver> driver;
+    std::set<uint8_t> sent_keys;
+    std::set<uint8_t> shifted_keys;
+};
+
+TEST_F(TappingRollover, TwelveKeyRolloverOverHeldModTapKeepsEveryKey) {
+    press_key(0, 0);
+    run_one_scan_loop();
+    roll_twelve_keys();
+    release_key(0, 0);
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+
+    for (uint8_t keycode = KC_K; keycode <= KC_V; keycode++) {
+        EXPECT_EQ(sent_keys.count(keycode), 1u) << "keycode " << +keycode << " was lost";
+        EXPECT_EQ(shifted_keys.count(keycode), 1u) << "keycode " << +keycode << " was not shifted";
+    }
+    EXPECT_EQ(sent_keys.count(KC_SPC), 0u);
+    waiting_buffer_stats_t stats = waiting_buffer_get_stats();
+    EXPECT_EQ(stats.high_water, WAITING_BUFFER_SIZE - 1);
+    EXPECT_GE(stats.resolved, 1u);
+    EXPECT_EQ(stats.dropped, 0u);
+}
+
+TEST_F(TappingRollover, ShortRollWithinTheBufferStillWaits) {
+    press_key(0, 0);
+    run_one_scan_loop();
+    press_key(0, 1);
+    run_one_scan_loop();
+    release_key(0, 1);
+    run_one_scan_loop();
+    release_key(0, 0);
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM);
+
+    waiting_buffer_stats_t stats = waiting_buffer_get_stats();
+    EXPECT_EQ(stats.high_water, 3u);
+    EXPECT_EQ(stats.resolved, 0u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(sent_keys.count(KC_K), 1u);
+}
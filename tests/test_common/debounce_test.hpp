@@ -0,0 +1,99 @@
+/* Copyright 2017 Fred Sundvik
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_TEST_COMMON_DEBOUNCE_TEST_HPP_
+#define TESTS_TEST_COMMON_DEBOUNCE_TEST_HPP_
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "debounce.h"
+    void set_time(uint32_t t);
+    void advance_time(uint32_t ms);
+}
+
+/* Drives a debounce algorithm the way quantum/matrix.c does: one call per
+ * 1 ms scan, with changed set when the raw matrix differs from the last scan.
+ */
+class DebounceTest : public testing::Test {
+public:
+    void SetUp() override {
+        set_time(0);
+        for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+            raw[i] = 0;
+            last_raw[i] = 0;
+            cooked[i] = 0;
+        }
+        debounce_init(MATRIX_ROWS);
+    }
+
+    void set_key(uint8_t col, uint8_t row, bool pressed) {
+        matrix_row_t mask = (matrix_row_t)1 << col;
+        raw[row] = pressed ? (raw[row] | mask) : (raw[row] & ~mask);
+    }
+
+    bool is_pressed(uint8_t col, uint8_t row) {
+        return cooked[row] & ((matrix_row_t)1 << col);
+    }
+
+    void scan() {
+        bool changed = false;
+        for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+            changed |= raw[i] != last_raw[i];
+            last_raw[i] = raw[i];
+        }
+        debounce(raw, cooked, MATRIX_ROWS, changed);
+        advance_time(1);
+    }
+
+    void scan_for(unsigned ms) {
+        for (unsigned i = 0; i < ms; i++) {
+            scan();
+        }
+    }
+
+    /* Average cost of one scan in ns, with key (0, 0) toggling every
+     * chatter_interval scans, or never when it is 0.
+     */
+    double scan_cost(unsigned scans, unsigned chatter_interval) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < scans; i++) {
+            if (chatter_interval && i % chatter_interval == 0) {
+                set_key(0, 0, !(raw[0] & 1));
+            }
+            scan();
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / scans;
+    }
+
+    void report_scan_cost(const char* name) {
+        double idle = scan_cost(100000, 0);
+        double chatter = scan_cost(100000, 2);
+        printf("[ BENCH    ] %-20s %8.1f ns/scan idle %8.1f ns/scan chattering\n", name, idle, chatter);
+        RecordProperty("idle_ns_per_scan", std::to_string(idle));
+        RecordProperty("chatter_ns_per_scan", std::to_string(chatter));
+    }
+
+    matrix_row_t raw[MATRIX_ROWS];
+    matrix_row_t last_raw[MATRIX_ROWS];
+    matrix_row_t cooked[MATRIX_ROWS];
+};
+
+#endif /* TESTS_TEST_COMMON_DEBOUNCE_TEST_HPP_ */
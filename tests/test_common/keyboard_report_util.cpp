@@ -17,6 +17,10 @@
  #include "keyboard_report_util.hpp"
  #include <vector>
  #include <algorithm>
+ #include "host.h"
+ extern "C" {
+ #include "keycode_config.h"
+ }
  using namespace testing;
 
  namespace
@@ -24,7 +28,19 @@
      std::vector<uint8_t> get_keys(const report_keyboard_t& report) {
         std::vector<uint8_t> result;
         #if defined(NKRO_ENABLE)
-        #error NKRO support not implemented yet
+        if (keyboard_protocol && keymap_config.nkro) {
+            for(size_t i=0; i<KEYBOARD_REPORT_BITS * 8; i++) {
+                if (report.nkro.bits[i >> 3] & (1 << (i & 7))) {
+                    result.emplace_back(i);
+                }
+            }
+        } else {
+            for(size_t i=0; i<KEYBOARD_REPORT_KEYS; i++) {
+                if (report.keys[i]) {
+                    result.emplace_back(report.keys[i]);
+                }
+            }
+        }
         #elif defined(USB_6KRO_ENABLE)
         #error 6KRO support not implemented yet
         #else
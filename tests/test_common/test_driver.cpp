@@ -18,6 +18,9 @@
 
 TestDriver* TestDriver::m_this = nullptr;
 
+// Normally provided by the USB protocol layer, the tests always run in report protocol
+uint8_t keyboard_protocol = 1;
+
 TestDriver::TestDriver()
     : m_driver{
         &TestDriver::keyboard_leds,
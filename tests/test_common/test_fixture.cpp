@@ -22,7 +22,8 @@ using testing::Between;
 
 void TestFixture::SetUpTestCase() {
     TestDriver driver;
-    EXPECT_CALL(driver, send_keyboard_mock(_));
+    // nothing is held, so setting the default layer sends no report
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
     keyboard_init();
 }
 
@@ -48,6 +48,7 @@ endif
 
 ifeq ($(PLATFORM),TEST)
 	TMK_COMMON_SRC += $(PLATFORM_COMMON_DIR)/eeprom.c
+	TMK_COMMON_DEFS += -DPROTOCOL_TEST
 endif
 
 
@@ -87,6 +88,20 @@ ifeq ($(strip $(COMMAND_ENABLE)), yes)
     TMK_COMMON_DEFS += -DCOMMAND_ENABLE
 endif
 
+ifeq ($(strip $(LATENCY_STATS_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/latency_stats.c
+    TMK_COMMON_DEFS += -DLATENCY_STATS_ENABLE
+endif
+
+ifeq ($(strip $(PROFILE_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/profile.c
+    TMK_COMMON_DEFS += -DPROFILE_ENABLE
+endif
+
+ifeq ($(strip $(LAYER_CACHE_ENABLE)), yes)
+    TMK_COMMON_DEFS += -DLAYER_CACHE_ENABLE
+endif
+
 ifeq ($(strip $(NKRO_ENABLE)), yes)
     TMK_COMMON_DEFS += -DNKRO_ENABLE
 endif
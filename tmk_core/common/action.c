@@ -27,6 +27,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_util.h"
 #include "action.h"
 #include "wait.h"
+#include "latency_stats.h"
+#include "profile.h"
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -36,7 +38,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 int tp_buttons;
 
-#ifdef RETRO_TAPPING
+#if defined(RETRO_TAPPING) || defined(TAPPING_POLICY_ENABLE)
 int retro_tapping_counter = 0;
 #endif
 
@@ -44,16 +46,29 @@ int retro_tapping_counter = 0;
 #include <fauxclicky.h>
 #endif
 
+#ifdef POSITIONAL_COMBO_ENABLE
+#include "process_positional_combo.h"
+#endif
+
 /** \brief Called to execute an action.
  *
  * FIXME: Needs documentation.
  */
 void action_exec(keyevent_t event)
 {
+    PROFILE_START(ACTION_EXEC);
+#ifdef POSITIONAL_COMBO_ENABLE
+    if (!IS_NOEVENT(event) && !process_positional_combo(event)) {
+        // held back or part of a combo, run the tapping state as a tick
+        event.key = (keypos_t){ .col = 255, .row = 255 };
+        event.pressed = false;
+    }
+#endif
     if (!IS_NOEVENT(event)) {
         dprint("\n---- action_exec: start -----\n");
         dprint("EVENT: "); debug_event(event); dprintln();
-#ifdef RETRO_TAPPING
+        latency_stats_event(event);
+#if defined(RETRO_TAPPING) || defined(TAPPING_POLICY_ENABLE)
         retro_tapping_counter++;
 #endif
     }
@@ -93,6 +108,8 @@ void action_exec(keyevent_t event)
         dprint("processed: "); debug_record(record); dprintln();
     }
 #endif
+    latency_stats_event_done();
+    PROFILE_STOP(ACTION_EXEC);
 }
 
 #ifdef SWAP_HANDS_ENABLE
@@ -173,7 +190,10 @@ void process_record(keyrecord_t *record)
 {
     if (IS_NOEVENT(record->event)) { return; }
 
-    if(!process_record_quantum(record))
+    PROFILE_PROCESS_START(RECORD);
+    bool processed = process_record_quantum(record);
+    PROFILE_PROCESS_STOP(RECORD);
+    if (!processed)
         return;
 
     action_t action = store_or_get_action(record->event.pressed, record->event.key);
@@ -308,7 +328,15 @@ void process_action(keyrecord_t *record, action_t action)
                     default:
                         if (event.pressed) {
                             if (tap_count > 0) {
-#ifndef IGNORE_MOD_TAP_INTERRUPT
+#if defined(TAPPING_POLICY_ENABLE)
+                                if (record->tap.interrupted &&
+                                        !(tapping_policy_flags(event.key) & TAPPING_IGNORE_MOD_TAP_INTERRUPT)) {
+                                    dprint("mods_tap: tap: cancel: add_mods\n");
+                                    // ad hoc: set 0 to cancel tap
+                                    record->tap.count = 0;
+                                    register_mods(mods);
+                                } else
+#elif !defined(IGNORE_MOD_TAP_INTERRUPT)
                                 if (record->tap.interrupted) {
                                     dprint("mods_tap: tap: cancel: add_mods\n");
                                     // ad hoc: set 0 to cancel tap
@@ -403,8 +431,8 @@ void process_action(keyrecord_t *record, action_t action)
                 /* Default Layer Bitwise Operation */
                 if (!event.pressed) {
                     uint8_t shift = action.layer_bitop.part*4;
-                    uint32_t bits = ((uint32_t)action.layer_bitop.bits)<<shift;
-                    uint32_t mask = (action.layer_bitop.xbit) ? ~(((uint32_t)0xf)<<shift) : 0;
+                    layer_state_t bits = (layer_state_t)(((uint32_t)action.layer_bitop.bits)<<shift);
+                    layer_state_t mask = (action.layer_bitop.xbit) ? ~(layer_state_t)(((uint32_t)0xf)<<shift) : 0;
                     switch (action.layer_bitop.op) {
                         case OP_BIT_AND: default_layer_and(bits | mask); break;
                         case OP_BIT_OR:  default_layer_or(bits | mask);  break;
@@ -417,8 +445,8 @@ void process_action(keyrecord_t *record, action_t action)
                 if (event.pressed ? (action.layer_bitop.on & ON_PRESS) :
                                     (action.layer_bitop.on & ON_RELEASE)) {
                     uint8_t shift = action.layer_bitop.part*4;
-                    uint32_t bits = ((uint32_t)action.layer_bitop.bits)<<shift;
-                    uint32_t mask = (action.layer_bitop.xbit) ? ~(((uint32_t)0xf)<<shift) : 0;
+                    layer_state_t bits = (layer_state_t)(((uint32_t)action.layer_bitop.bits)<<shift);
+                    layer_state_t mask = (action.layer_bitop.xbit) ? ~(layer_state_t)(((uint32_t)0xf)<<shift) : 0;
                     switch (action.layer_bitop.op) {
                         case OP_BIT_AND: layer_and(bits | mask); break;
                         case OP_BIT_OR:  layer_or(bits | mask);  break;
@@ -652,8 +680,13 @@ void process_action(keyrecord_t *record, action_t action)
 #endif
 
 #ifndef NO_ACTION_TAPPING
+  #if defined(RETRO_TAPPING) || defined(TAPPING_POLICY_ENABLE)
   #ifdef RETRO_TAPPING
   if (!is_tap_key(record->event.key)) {
+  #else
+  // only the tap key whose policy was loaded on its press can retro tap
+  if (!(tapping_policy_flags(event.key) & TAPPING_RETRO_TAPPING)) {
+  #endif
     retro_tapping_counter = 0;
   } else {
     if (event.pressed) {
@@ -666,7 +699,11 @@ void process_action(keyrecord_t *record, action_t action)
       if (tap_count > 0) {
         retro_tapping_counter = 0;
       } else {
+      #ifdef TAPPING_POLICY_ENABLE
+        if (retro_tapping_counter == 2 && (tapping_policy_flags(event.key) & TAPPING_RETRO_TAPPING)) {
+      #else
         if (retro_tapping_counter == 2) {
+      #endif
           register_code(action.layer_tap.code);
           unregister_code(action.layer_tap.code);
         }
@@ -825,6 +862,8 @@ void unregister_code(uint8_t code)
 #endif
 
     else if IS_KEY(code) {
+        // a layer change may already have cleared it from the report
+        if (!is_key_in_report(keyboard_report, code)) return;
         del_key(code);
         send_keyboard_report();
     }
@@ -863,7 +902,8 @@ void register_mods(uint8_t mods)
  */
 void unregister_mods(uint8_t mods)
 {
-    if (mods) {
+    // a tap key released by the next tap key may release its mods again
+    if (mods & get_mods()) {
         del_mods(mods);
         send_keyboard_report();
     }
@@ -899,6 +939,28 @@ void clear_keyboard_but_mods(void)
 #endif
 }
 
+/** \brief Clear held keys after a layer change
+ *
+ * Same as clear_keyboard_but_mods(), but leaves the keyboard report alone when
+ * it holds nothing to clear, so a layer change with only mods down does not
+ * resend an unchanged report.
+ */
+void clear_held_keys(void)
+{
+    if (get_weak_mods() || get_macro_mods() || has_anykey(keyboard_report)) {
+        clear_keyboard_but_mods();
+        return;
+    }
+#ifdef MOUSEKEY_ENABLE
+    mousekey_clear();
+    mousekey_send();
+#endif
+#ifdef EXTRAKEY_ENABLE
+    host_system_send(0);
+    host_consumer_send(0);
+#endif
+}
+
 /** \brief Utilities for actions. (FIXME: Needs better description)
  *
  * FIXME: Needs documentation.
@@ -941,7 +1003,7 @@ bool is_tap_key(keypos_t key)
  */
 void debug_event(keyevent_t event)
 {
-    dprintf("%04X%c(%u)", (event.key.row<<8 | event.key.col), (event.pressed ? 'd' : 'u'), event.time);
+    dprintf("%04X%c(%u)", (event.key.row<<8 | event.key.col), (event.pressed ? 'd' : 'u'), (uint16_t)event.time);
 }
 
 /** \brief Debug print (FIXME: Needs better description)
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "action.h"
 #include "util.h"
@@ -13,14 +14,14 @@
 
 /** \brief Default Layer State
  */
-uint32_t default_layer_state = 0;
+layer_state_t default_layer_state = 0;
 
 /** \brief Default Layer State Set At Keyboard Level
  *
  * FIXME: Needs docs
  */
 __attribute__((weak))
-uint32_t default_layer_state_set_kb(uint32_t state) {
+layer_state_t default_layer_state_set_kb(layer_state_t state) {
     return state;
 }
 
@@ -28,14 +29,24 @@ uint32_t default_layer_state_set_kb(uint32_t state) {
  *
  * FIXME: Needs docs
  */
-static void default_layer_state_set(uint32_t state)
+static void default_layer_state_set(layer_state_t state)
 {
     state = default_layer_state_set_kb(state);
     debug("default_layer_state: ");
     default_layer_debug(); debug(" to ");
     default_layer_state = state;
     default_layer_debug(); debug("\n");
-    clear_keyboard_but_mods(); // To avoid stuck keys
+    clear_held_keys(); // To avoid stuck keys
+}
+
+/* print a layer state as hex followed by its highest layer */
+static inline void layer_state_debug(layer_state_t state)
+{
+#ifdef LAYER_STATE_64BIT
+    dprintf("%08lX%08lX(%u)", (uint32_t)(state >> 32), (uint32_t)state, get_highest_layer(state));
+#else
+    dprintf("%08lX(%u)", (uint32_t)state, get_highest_layer(state));
+#endif
 }
 
 /** \brief Default Layer Print
@@ -44,14 +55,14 @@ static void default_layer_state_set(uint32_t state)
  */
 void default_layer_debug(void)
 {
-    dprintf("%08lX(%u)", default_layer_state, biton32(default_layer_state));
+    layer_state_debug(default_layer_state);
 }
 
 /** \brief Default Layer Set
  *
  * FIXME: Needs docs
  */
-void default_layer_set(uint32_t state)
+void default_layer_set(layer_state_t state)
 {
     default_layer_state_set(state);
 }
@@ -61,7 +72,7 @@ void default_layer_set(uint32_t state)
  *
  * FIXME: Needs docs
  */
-void default_layer_or(uint32_t state)
+void default_layer_or(layer_state_t state)
 {
     default_layer_state_set(default_layer_state | state);
 }
@@ -69,7 +80,7 @@ void default_layer_or(uint32_t state)
  *
  * FIXME: Needs docs
  */
-void default_layer_and(uint32_t state)
+void default_layer_and(layer_state_t state)
 {
     default_layer_state_set(default_layer_state & state);
 }
@@ -77,7 +88,7 @@ void default_layer_and(uint32_t state)
  *
  * FIXME: Needs docs
  */
-void default_layer_xor(uint32_t state)
+void default_layer_xor(layer_state_t state)
 {
     default_layer_state_set(default_layer_state ^ state);
 }
@@ -87,14 +98,14 @@ void default_layer_xor(uint32_t state)
 #ifndef NO_ACTION_LAYER
 /** \brief Keymap Layer State
  */
-uint32_t layer_state = 0;
+layer_state_t layer_state = 0;
 
 /** \brief Layer state set user
  *
  * FIXME: Needs docs
  */
 __attribute__((weak))
-uint32_t layer_state_set_user(uint32_t state) {
+layer_state_t layer_state_set_user(layer_state_t state) {
     return state;
 }
 
@@ -103,7 +114,7 @@ uint32_t layer_state_set_user(uint32_t state) {
  * FIXME: Needs docs
  */
 __attribute__((weak))
-uint32_t layer_state_set_kb(uint32_t state) {
+layer_state_t layer_state_set_kb(layer_state_t state) {
     return layer_state_set_user(state);
 }
 
@@ -111,14 +122,14 @@ uint32_t layer_state_set_kb(uint32_t state) {
  *
  * FIXME: Needs docs
  */
-void layer_state_set(uint32_t state)
+void layer_state_set(layer_state_t state)
 {
     state = layer_state_set_kb(state);
     dprint("layer_state: ");
     layer_debug(); dprint(" to ");
     layer_state = state;
     layer_debug(); dprintln();
-    clear_keyboard_but_mods(); // To avoid stuck keys
+    clear_held_keys(); // To avoid stuck keys
 }
 
 /** \brief Layer clear
@@ -143,9 +154,9 @@ bool layer_state_is(uint8_t layer)
  *
  * FIXME: Needs docs
  */
-bool layer_state_cmp(uint32_t cmp_layer_state, uint8_t layer) {
+bool layer_state_cmp(layer_state_t cmp_layer_state, uint8_t layer) {
     if (!cmp_layer_state) { return layer == 0; }
-    return (cmp_layer_state & (1UL<<layer)) != 0;
+    return (cmp_layer_state & ((layer_state_t)1 << layer)) != 0;
 }
 
 /** \brief Layer move
@@ -154,7 +165,7 @@ bool layer_state_cmp(uint32_t cmp_layer_state, uint8_t layer) {
  */
 void layer_move(uint8_t layer)
 {
-    layer_state_set(1UL<<layer);
+    layer_state_set((layer_state_t)1 << layer);
 }
 
 /** \brief Layer on
@@ -163,7 +174,7 @@ void layer_move(uint8_t layer)
  */
 void layer_on(uint8_t layer)
 {
-    layer_state_set(layer_state | (1UL<<layer));
+    layer_state_set(layer_state | ((layer_state_t)1 << layer));
 }
 
 /** \brief Layer off
@@ -172,7 +183,7 @@ void layer_on(uint8_t layer)
  */
 void layer_off(uint8_t layer)
 {
-    layer_state_set(layer_state & ~(1UL<<layer));
+    layer_state_set(layer_state & ~((layer_state_t)1 << layer));
 }
 
 /** \brief Layer invert
@@ -181,14 +192,14 @@ void layer_off(uint8_t layer)
  */
 void layer_invert(uint8_t layer)
 {
-    layer_state_set(layer_state ^ (1UL<<layer));
+    layer_state_set(layer_state ^ ((layer_state_t)1 << layer));
 }
 
 /** \brief Layer or
  *
  * FIXME: Needs docs
  */
-void layer_or(uint32_t state)
+void layer_or(layer_state_t state)
 {
     layer_state_set(layer_state | state);
 }
@@ -196,7 +207,7 @@ void layer_or(uint32_t state)
  *
  * FIXME: Needs docs
  */
-void layer_and(uint32_t state)
+void layer_and(layer_state_t state)
 {
     layer_state_set(layer_state & state);
 }
@@ -204,7 +215,7 @@ void layer_and(uint32_t state)
  *
  * FIXME: Needs docs
  */
-void layer_xor(uint32_t state)
+void layer_xor(layer_state_t state)
 {
     layer_state_set(layer_state ^ state);
 }
@@ -215,11 +226,44 @@ void layer_xor(uint32_t state)
  */
 void layer_debug(void)
 {
-    dprintf("%08lX(%u)", layer_state, biton32(layer_state));
+    layer_state_debug(layer_state);
 }
 #endif
 
 #if !defined(NO_ACTION_LAYER) && defined(PREVENT_STUCK_MODIFIERS)
+#if defined(SOURCE_LAYERS_CACHE_PER_KEY) && MAX_LAYER_BITS <= 4
+/* one nibble per key, two keys per byte */
+uint8_t source_layers_cache[(MATRIX_ROWS * MATRIX_COLS + 1) / 2] = {0};
+
+void update_source_layers_cache(keypos_t key, uint8_t layer)
+{
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+    const uint8_t shift = (key_number & 1) * 4;
+    uint8_t *storage = &source_layers_cache[key_number / 2];
+
+    *storage = (*storage & ~(0x0F << shift)) | ((layer & 0x0F) << shift);
+}
+
+uint8_t read_source_layers_cache(keypos_t key)
+{
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+
+    return (source_layers_cache[key_number / 2] >> ((key_number & 1) * 4)) & 0x0F;
+}
+#elif defined(SOURCE_LAYERS_CACHE_PER_KEY)
+/* one byte per key */
+uint8_t source_layers_cache[MATRIX_ROWS][MATRIX_COLS] = {{0}};
+
+void update_source_layers_cache(keypos_t key, uint8_t layer)
+{
+    source_layers_cache[key.row][key.col] = layer;
+}
+
+uint8_t read_source_layers_cache(keypos_t key)
+{
+    return source_layers_cache[key.row][key.col];
+}
+#else
 uint8_t source_layers_cache[(MATRIX_ROWS * MATRIX_COLS + 7) / 8][MAX_LAYER_BITS] = {{0}};
 
 void update_source_layers_cache(keypos_t key, uint8_t layer)
@@ -253,6 +297,7 @@ uint8_t read_source_layers_cache(keypos_t key)
     return layer;
 }
 #endif
+#endif
 
 /** \brief Store or get action (FIXME: Needs better summary)
  *
@@ -284,6 +329,47 @@ action_t store_or_get_action(bool pressed, keypos_t key)
 }
 
 
+#ifndef NO_ACTION_LAYER
+/** \brief Find the topmost non-transparent layer of key in layers
+ */
+static int8_t layer_switch_find_layer(layer_state_t layers, keypos_t key)
+{
+    /* check top layer first, visiting only the layers that are on */
+    while (layers) {
+        uint8_t i = layer_state_msb(layers);
+        if (action_for_key(i, key).code != ACTION_TRANSPARENT) {
+            return i;
+        }
+        layers &= ~((layer_state_t)1 << i);
+    }
+    /* fall back to layer 0 */
+    return 0;
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_CACHE_ENABLE)
+#define LAYER_CACHE_INVALID 0xFF
+
+/* Resolved layer of every key for layer_cache_state, filled in on the first
+ * press of the key. Any change of layer_state or default_layer_state, also
+ * by direct assignment, empties it on the next lookup.
+ */
+static uint8_t layer_cache[MATRIX_ROWS][MATRIX_COLS];
+static layer_state_t layer_cache_state = 0;
+static bool layer_cache_valid = false;
+
+/** \brief Layer cache invalidate
+ *
+ * Empties the resolved layer cache. Only needed when the keymap itself
+ * changes at run time, for example a keymap_key_to_keycode() reading from
+ * EEPROM; layer changes are picked up on their own.
+ */
+void layer_cache_invalidate(void)
+{
+    layer_cache_valid = false;
+}
+#endif
+
 /** \brief Layer switch get layer
  *
  * FIXME: Needs docs
@@ -291,23 +377,24 @@ action_t store_or_get_action(bool pressed, keypos_t key)
 int8_t layer_switch_get_layer(keypos_t key)
 {
 #ifndef NO_ACTION_LAYER
-    action_t action;
-    action.code = ACTION_TRANSPARENT;
-
-    uint32_t layers = layer_state | default_layer_state;
-    /* check top layer first */
-    for (int8_t i = 31; i >= 0; i--) {
-        if (layers & (1UL<<i)) {
-            action = action_for_key(i, key);
-            if (action.code != ACTION_TRANSPARENT) {
-                return i;
-            }
+    layer_state_t layers = layer_state | default_layer_state;
+#ifdef LAYER_CACHE_ENABLE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        if (!layer_cache_valid || layer_cache_state != layers) {
+            memset(layer_cache, LAYER_CACHE_INVALID, sizeof(layer_cache));
+            layer_cache_state = layers;
+            layer_cache_valid = true;
+        }
+        uint8_t *cached = &layer_cache[key.row][key.col];
+        if (*cached == LAYER_CACHE_INVALID) {
+            *cached = layer_switch_find_layer(layers, key);
         }
+        return *cached;
     }
-    /* fall back to layer 0 */
-    return 0;
+#endif
+    return layer_switch_find_layer(layers, key);
 #else
-    return biton32(default_layer_state);
+    return get_highest_layer(default_layer_state);
 #endif
 }
 
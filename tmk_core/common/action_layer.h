@@ -20,23 +20,55 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdint.h>
 #include "keyboard.h"
 #include "action.h"
+#include "util.h"
+
+
+/*
+ * Layer state type
+ *
+ * Each layer is one bit of the state, so the width of the state bounds the
+ * number of layers. Narrower states are cheaper to update on 8-bit MCUs.
+ */
+#if defined(LAYER_STATE_8BIT)
+typedef uint8_t layer_state_t;
+#define MAX_LAYER_BITS 3
+#define layer_state_msb(state) bitmsb(state)
+#elif defined(LAYER_STATE_16BIT)
+typedef uint16_t layer_state_t;
+#define MAX_LAYER_BITS 4
+#define layer_state_msb(state) bitmsb16(state)
+#elif defined(LAYER_STATE_64BIT)
+typedef uint64_t layer_state_t;
+#define MAX_LAYER_BITS 6
+#define layer_state_msb(state) bitmsb64(state)
+#else
+typedef uint32_t layer_state_t;
+#define MAX_LAYER_BITS 5
+#define layer_state_msb(state) bitmsb32(state)
+#endif
+#define MAX_LAYER (1 << MAX_LAYER_BITS)
+
+/* return the highest layer set in state, or 0 when no layer is set */
+static inline uint8_t get_highest_layer(layer_state_t state) {
+    return state ? layer_state_msb(state) : 0;
+}
 
 
 /*
  * Default Layer
  */
-extern uint32_t default_layer_state;
+extern layer_state_t default_layer_state;
 void default_layer_debug(void);
-void default_layer_set(uint32_t state);
+void default_layer_set(layer_state_t state);
 
 __attribute__((weak))
-uint32_t default_layer_state_set_kb(uint32_t state);
+layer_state_t default_layer_state_set_kb(layer_state_t state);
 
 #ifndef NO_ACTION_LAYER
 /* bitwise operation */
-void default_layer_or(uint32_t state);
-void default_layer_and(uint32_t state);
-void default_layer_xor(uint32_t state);
+void default_layer_or(layer_state_t state);
+void default_layer_and(layer_state_t state);
+void default_layer_xor(layer_state_t state);
 #else
 #define default_layer_or(state)
 #define default_layer_and(state)
@@ -48,11 +80,11 @@ void default_layer_xor(uint32_t state);
  * Keymap Layer
  */
 #ifndef NO_ACTION_LAYER
-extern uint32_t layer_state;
+extern layer_state_t layer_state;
 
-void layer_state_set(uint32_t state);
+void layer_state_set(layer_state_t state);
 bool layer_state_is(uint8_t layer);
-bool layer_state_cmp(uint32_t layer1, uint8_t layer2);
+bool layer_state_cmp(layer_state_t layer1, uint8_t layer2);
 
 void layer_debug(void);
 void layer_clear(void);
@@ -61,15 +93,15 @@ void layer_on(uint8_t layer);
 void layer_off(uint8_t layer);
 void layer_invert(uint8_t layer);
 /* bitwise operation */
-void layer_or(uint32_t state);
-void layer_and(uint32_t state);
-void layer_xor(uint32_t state);
+void layer_or(layer_state_t state);
+void layer_and(layer_state_t state);
+void layer_xor(layer_state_t state);
 #else
 #define layer_state                    0
 
 #define layer_state_set(layer)
 #define layer_state_is(layer)          (layer == 0)
-#define layer_state_cmp(state, layer)  (state == 0 ? layer == 0 : (state & 1UL << layer) != 0)
+#define layer_state_cmp(state, layer)  (state == 0 ? layer == 0 : (state & (layer_state_t)1 << layer) != 0)
 
 #define layer_debug()
 #define layer_clear()
@@ -82,15 +114,13 @@ void layer_xor(uint32_t state);
 #define layer_xor(state)
 
 __attribute__((weak))
-uint32_t layer_state_set_user(uint32_t state);
+layer_state_t layer_state_set_user(layer_state_t state);
 __attribute__((weak))
-uint32_t layer_state_set_kb(uint32_t state);
+layer_state_t layer_state_set_kb(layer_state_t state);
 #endif
 
 /* pressed actions cache */
 #if !defined(NO_ACTION_LAYER) && defined(PREVENT_STUCK_MODIFIERS)
-/* The number of bits needed to represent the layer number: log2(32). */
-#define MAX_LAYER_BITS 5
 void update_source_layers_cache(keypos_t key, uint8_t layer);
 uint8_t read_source_layers_cache(keypos_t key);
 #endif
@@ -99,6 +129,13 @@ action_t store_or_get_action(bool pressed, keypos_t key);
 /* return the topmost non-transparent layer currently associated with key */
 int8_t layer_switch_get_layer(keypos_t key);
 
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_CACHE_ENABLE)
+/* forget the cached layer of every key, for run time keymap changes */
+void layer_cache_invalidate(void);
+#else
+#define layer_cache_invalidate()
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
 
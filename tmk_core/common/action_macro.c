@@ -64,6 +64,9 @@ void action_macro_play(const macro_t *macro_p)
             case WAIT:
                 MACRO_READ();
                 dprintf("WAIT(%u)\n", macro);
+#ifdef QMK_ALL_KEYS_PER_SCAN
+                keyboard_report_batch_flush();
+#endif
                 { uint8_t ms = macro; while (ms--) wait_ms(1); }
                 break;
             case INTERVAL:
@@ -83,6 +86,9 @@ void action_macro_play(const macro_t *macro_p)
                 return;
         }
         // interval
+#ifdef QMK_ALL_KEYS_PER_SCAN
+        if (interval) keyboard_report_batch_flush();
+#endif
         { uint8_t ms = interval; while (ms--) wait_ms(1); }
     }
 }
@@ -5,6 +5,9 @@
 #include "action_tapping.h"
 #include "keycode.h"
 #include "timer.h"
+#ifdef TAPPING_POLICY_ENABLE
+#include "keymap.h"
+#endif
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -18,17 +21,39 @@
 #define IS_TAPPING_PRESSED()    (IS_TAPPING() && tapping_key.event.pressed)
 #define IS_TAPPING_RELEASED()   (IS_TAPPING() && !tapping_key.event.pressed)
 #define IS_TAPPING_KEY(k)       (IS_TAPPING() && KEYEQ(tapping_key.event.key, (k)))
-#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_16(e.time, tapping_key.event.time) < TAPPING_TERM)
+#ifdef TAPPING_POLICY_ENABLE
+#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_EVENT(e.time, tapping_key.event.time) < tapping_term)
+#define IS_PERMISSIVE_HOLD()    (tapping_term >= 500 || (tapping_flags & TAPPING_PERMISSIVE_HOLD))
+#else
+#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_EVENT(e.time, tapping_key.event.time) < TAPPING_TERM)
+#define IS_PERMISSIVE_HOLD()    true
+#define tapping_policy_load(key)
+#endif
+
+#if WAITING_BUFFER_SIZE < 2 || WAITING_BUFFER_SIZE > 128 || (WAITING_BUFFER_SIZE & (WAITING_BUFFER_SIZE - 1))
+#error "WAITING_BUFFER_SIZE must be a power of two from 2 to 128"
+#endif
+#define WAITING_BUFFER_NEXT(i)  (((i) + 1) & (WAITING_BUFFER_SIZE - 1))
+#define WAITING_BUFFER_COUNT()  ((uint8_t)(waiting_buffer_head - waiting_buffer_tail) & (WAITING_BUFFER_SIZE - 1))
 
 
 static keyrecord_t tapping_key = {};
+#ifdef TAPPING_POLICY_ENABLE
+/* policy of the last tap key pressed */
+static keypos_t tapping_policy_key = { .row = 0xFF, .col = 0xFF };
+static uint16_t tapping_policy_keycode = KC_NO;
+static uint16_t tapping_term = TAPPING_TERM;
+static uint8_t tapping_flags = TAPPING_DEFAULT_FLAGS;
+#endif
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t waiting_buffer_head = 0;
 static uint8_t waiting_buffer_tail = 0;
+static waiting_buffer_stats_t waiting_buffer_stats = {};
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
 static void waiting_buffer_clear(void);
+static void waiting_buffer_process(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
 static void waiting_buffer_scan_tap(void);
@@ -36,6 +61,88 @@ static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
 
+#ifdef TAPPING_POLICY_ENABLE
+/** \brief Tapping policy find
+ *
+ * Looks up the policy of keycode, or the defaults when it has none.
+ */
+static void tapping_policy_find(uint16_t keycode, uint16_t *term, uint8_t *flags)
+{
+    *term = TAPPING_TERM;
+    *flags = TAPPING_DEFAULT_FLAGS;
+    for (uint8_t i = 0; i < tapping_policies_count; i++) {
+        if (pgm_read_word(&tapping_policies[i].keycode) == keycode) {
+            uint16_t policy_term = pgm_read_word(&tapping_policies[i].term);
+            if (policy_term) {
+                *term = policy_term;
+            }
+            *flags = pgm_read_byte(&tapping_policies[i].flags);
+            return;
+        }
+    }
+}
+
+/** \brief Tapping policy load
+ *
+ * Makes the policy of a newly pressed tap key the current one. The table is
+ * only searched when the keycode differs from the last tap key's, so tapping
+ * the same key again costs one keycode lookup.
+ */
+static void tapping_policy_load(keypos_t key)
+{
+    uint16_t keycode = keymap_key_to_keycode(layer_switch_get_layer(key), key);
+
+    if (keycode != tapping_policy_keycode) {
+        tapping_policy_find(keycode, &tapping_term, &tapping_flags);
+        tapping_policy_keycode = keycode;
+    }
+    tapping_policy_key = key;
+}
+
+/** \brief Tapping policy flags
+ *
+ * Returns the flags loaded when the tap key at key was pressed, or the
+ * defaults for any other key. Unlike get_tapping_flags() it never looks the
+ * policy up, so the action code can call it on every event.
+ */
+uint8_t tapping_policy_flags(keypos_t key)
+{
+    return KEYEQ(key, tapping_policy_key) ? tapping_flags : TAPPING_DEFAULT_FLAGS;
+}
+
+/** \brief Get tapping term
+ *
+ * Returns the tapping term of the tap key at key.
+ */
+uint16_t get_tapping_term(keypos_t key)
+{
+    uint16_t term;
+    uint8_t flags;
+
+    if (KEYEQ(key, tapping_policy_key)) {
+        return tapping_term;
+    }
+    tapping_policy_find(keymap_key_to_keycode(layer_switch_get_layer(key), key), &term, &flags);
+    return term;
+}
+
+/** \brief Get tapping flags
+ *
+ * Returns the tapping_policy_flags of the tap key at key.
+ */
+uint8_t get_tapping_flags(keypos_t key)
+{
+    uint16_t term;
+    uint8_t flags;
+
+    if (KEYEQ(key, tapping_policy_key)) {
+        return tapping_flags;
+    }
+    tapping_policy_find(keymap_key_to_keycode(layer_switch_get_layer(key), key), &term, &flags);
+    return flags;
+}
+#endif
+
 /** \brief Action Tapping Process
  *
  * FIXME: Needs doc
@@ -46,10 +153,20 @@ void action_tapping_process(keyrecord_t record)
         if (!IS_NOEVENT(record.event)) {
             debug("processed: "); debug_record(record); debug("\n");
         }
-    } else {
+    } else if (!waiting_buffer_enq(record)) {
+        if (IS_TAPPING_PRESSED() && tapping_key.tap.count == 0) {
+            // settle the undecided tap key as hold, so the buffered keys can go out
+            debug("OVERFLOW: RESOLVE TAPPING KEY AS HOLD\n");
+            waiting_buffer_stats.resolved++;
+            process_record(&tapping_key);
+            tapping_key = (keyrecord_t){};
+            debug_tapping_key();
+            waiting_buffer_process();
+        }
         if (!waiting_buffer_enq(record)) {
             // clear all in case of overflow.
             debug("OVERFLOW: CLEAR ALL STATES\n");
+            waiting_buffer_stats.dropped++;
             clear_keyboard();
             waiting_buffer_clear();
             tapping_key = (keyrecord_t){};
@@ -60,19 +177,40 @@ void action_tapping_process(keyrecord_t record)
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            debug("processed: waiting_buffer["); debug_dec(waiting_buffer_tail); debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]); debug("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
 }
 
+/** \brief Action tapping holds events
+ *
+ * True while a tap key is pressed and undecided, or events wait behind it,
+ * so the reports for those presses are still to come.
+ */
+bool action_tapping_holds_events(void)
+{
+    return (IS_TAPPING_PRESSED() && tapping_key.tap.count == 0) || WAITING_BUFFER_COUNT();
+}
+
+/** \brief Waiting buffer get stats
+ *
+ * Returns the depth and overflow counts of the waiting buffer.
+ */
+waiting_buffer_stats_t waiting_buffer_get_stats(void)
+{
+    return waiting_buffer_stats;
+}
+
+/** \brief Waiting buffer clear stats
+ *
+ * Resets the depth and overflow counts of the waiting buffer.
+ */
+void waiting_buffer_clear_stats(void)
+{
+    waiting_buffer_stats = (waiting_buffer_stats_t){};
+}
+
 
 /** \brief Tapping
  *
@@ -97,15 +235,22 @@ bool process_tapping(keyrecord_t *keyp)
 
                     // copy tapping state
                     keyp->tap = tapping_key.tap;
+                    if (tapping_key.tap.count == 0) {
+                        // an interrupted mod-tap took its press as a hold; settle it
+                        // now, or the queued release comes back through this branch
+                        debug("Tapping: End. No tap. Interrupted.\n");
+                        tapping_key = (keyrecord_t){};
+                        debug_tapping_key();
+                    }
                     // enqueue
                     return false;
                 }
-#if TAPPING_TERM >= 500 || defined PERMISSIVE_HOLD
+#if TAPPING_TERM >= 500 || defined PERMISSIVE_HOLD || defined TAPPING_POLICY_ENABLE
                 /* Process a key typed within TAPPING_TERM
                  * This can register the key before settlement of tapping,
                  * useful for long TAPPING_TERM but may prevent fast typing.
                  */
-                else if (IS_RELEASED(event) && waiting_buffer_typed(event)) {
+                else if (IS_PERMISSIVE_HOLD() && IS_RELEASED(event) && waiting_buffer_typed(event)) {
                     debug("Tapping: End. No tap. Interfered by typing key\n");
                     process_record(&tapping_key);
                     tapping_key = (keyrecord_t){};
@@ -171,6 +316,7 @@ bool process_tapping(keyrecord_t *keyp)
                         debug("Tapping: Start while last tap(1).\n");
                     }
                     tapping_key = *keyp;
+                    tapping_policy_load(event.key);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -215,6 +361,7 @@ bool process_tapping(keyrecord_t *keyp)
                         debug("Tapping: Start while last timeout tap(1).\n");
                     }
                     tapping_key = *keyp;
+                    tapping_policy_load(event.key);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -251,6 +398,7 @@ bool process_tapping(keyrecord_t *keyp)
                     // Sequential tap can be interfered with other tap key.
                     debug("Tapping: Start with interfering other tap.\n");
                     tapping_key = *keyp;
+                    tapping_policy_load(event.key);
                     waiting_buffer_scan_tap();
                     debug_tapping_key();
                     return true;
@@ -281,6 +429,7 @@ bool process_tapping(keyrecord_t *keyp)
         if (event.pressed && is_tap_key(event.key)) {
             debug("Tapping: Start(Press tap key).\n");
             tapping_key = *keyp;
+            tapping_policy_load(event.key);
             process_record_tap_hint(&tapping_key);
             waiting_buffer_scan_tap();
             debug_tapping_key();
@@ -303,13 +452,16 @@ bool waiting_buffer_enq(keyrecord_t record)
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (WAITING_BUFFER_NEXT(waiting_buffer_head) == waiting_buffer_tail) {
         debug("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head = WAITING_BUFFER_NEXT(waiting_buffer_head);
+    if (WAITING_BUFFER_COUNT() > waiting_buffer_stats.high_water) {
+        waiting_buffer_stats.high_water = WAITING_BUFFER_COUNT();
+    }
 
     debug("waiting_buffer_enq: "); debug_waiting_buffer();
     return true;
@@ -325,13 +477,30 @@ void waiting_buffer_clear(void)
     waiting_buffer_tail = 0;
 }
 
+/** \brief Waiting buffer process
+ *
+ * Feeds the buffered events to process_tapping() in order, until one of
+ * them has to wait again.
+ */
+void waiting_buffer_process(void)
+{
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
+        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+            debug("processed: waiting_buffer["); debug_dec(waiting_buffer_tail); debug("] = ");
+            debug_record(waiting_buffer[waiting_buffer_tail]); debug("\n\n");
+        } else {
+            break;
+        }
+    }
+}
+
 /** \brief Waiting buffer typed
  *
  * FIXME: Needs docs
  */
 bool waiting_buffer_typed(keyevent_t event)
 {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed !=  waiting_buffer[i].event.pressed) {
             return true;
         }
@@ -346,7 +515,7 @@ bool waiting_buffer_typed(keyevent_t event)
 __attribute__((unused))
 bool waiting_buffer_has_anykey_pressed(void)
 {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (waiting_buffer[i].event.pressed) return true;
     }
     return false;
@@ -363,7 +532,7 @@ void waiting_buffer_scan_tap(void)
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (IS_TAPPING_KEY(waiting_buffer[i].event.key) &&
                 !waiting_buffer[i].event.pressed &&
                 WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
@@ -395,7 +564,7 @@ static void debug_tapping_key(void)
 static void debug_waiting_buffer(void)
 {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         debug("["); debug_dec(i); debug("]="); debug_record(waiting_buffer[i]); debug(" ");
     }
     debug("}\n");
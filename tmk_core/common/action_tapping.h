@@ -31,11 +31,78 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define TAPPING_TOGGLE  5
 #endif
 
+/* events held back while a tap key is undecided, must be a power of two */
+#ifndef WAITING_BUFFER_SIZE
 #define WAITING_BUFFER_SIZE 8
+#endif
+
+
+#if !defined(NO_ACTION_TAPPING) && defined(TAPPING_POLICY_ENABLE)
+#include "keyboard.h"
+#include "progmem.h"
+
+/* tapping behaviours a policy can turn on for its keycode */
+enum tapping_policy_flags {
+    TAPPING_PERMISSIVE_HOLD          = 1 << 0,
+    TAPPING_IGNORE_MOD_TAP_INTERRUPT = 1 << 1,
+    TAPPING_RETRO_TAPPING            = 1 << 2,
+};
 
+/* flags of keycodes without a policy, from the global options */
+#ifdef PERMISSIVE_HOLD
+#define TAPPING_DEFAULT_PERMISSIVE_HOLD TAPPING_PERMISSIVE_HOLD
+#else
+#define TAPPING_DEFAULT_PERMISSIVE_HOLD 0
+#endif
+#ifdef IGNORE_MOD_TAP_INTERRUPT
+#define TAPPING_DEFAULT_IGNORE_MOD_TAP_INTERRUPT TAPPING_IGNORE_MOD_TAP_INTERRUPT
+#else
+#define TAPPING_DEFAULT_IGNORE_MOD_TAP_INTERRUPT 0
+#endif
+#ifdef RETRO_TAPPING
+#define TAPPING_DEFAULT_RETRO_TAPPING TAPPING_RETRO_TAPPING
+#else
+#define TAPPING_DEFAULT_RETRO_TAPPING 0
+#endif
+#define TAPPING_DEFAULT_FLAGS (TAPPING_DEFAULT_PERMISSIVE_HOLD | TAPPING_DEFAULT_IGNORE_MOD_TAP_INTERRUPT | TAPPING_DEFAULT_RETRO_TAPPING)
+
+/* Tapping term and flags of one tap keycode, replacing TAPPING_TERM and
+ * the global flags for it. A term of 0 keeps TAPPING_TERM.
+ *
+ *   TAPPING_POLICIES(
+ *       { .keycode = SFT_T(KC_F),    .term = 150, .flags = TAPPING_PERMISSIVE_HOLD },
+ *       { .keycode = LT(1, KC_SPC),  .term = 300 },
+ *   );
+ */
+typedef struct {
+    uint16_t keycode;
+    uint16_t term;
+    uint8_t  flags;
+} tapping_policy_t;
+
+#define TAPPING_POLICIES(...) \
+    const tapping_policy_t PROGMEM tapping_policies[] = { __VA_ARGS__ }; \
+    const uint8_t tapping_policies_count = sizeof(tapping_policies) / sizeof(tapping_policies[0])
+
+extern const tapping_policy_t tapping_policies[];
+extern const uint8_t tapping_policies_count;
+
+uint16_t get_tapping_term(keypos_t key);
+uint8_t get_tapping_flags(keypos_t key);
+uint8_t tapping_policy_flags(keypos_t key);
+#endif
 
 #ifndef NO_ACTION_TAPPING
+typedef struct {
+    uint8_t  high_water;    /* most events ever held at once */
+    uint16_t resolved;      /* overflows settled by resolving the tap key as hold */
+    uint16_t dropped;       /* overflows that cleared all keys */
+} waiting_buffer_stats_t;
+
 void action_tapping_process(keyrecord_t record);
+bool action_tapping_holds_events(void);
+waiting_buffer_stats_t waiting_buffer_get_stats(void);
+void waiting_buffer_clear_stats(void);
 #endif
 
 #endif
@@ -43,6 +43,14 @@ static int8_t cb_count = 0;
 //report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
+#ifdef QMK_ALL_KEYS_PER_SCAN
+static bool report_batching = false;
+static int8_t report_batch_dir = 0;
+static report_keyboard_t last_sent_report;
+static report_keyboard_t pending_report;
+static void send_keyboard_report_batched(void);
+#endif
+
 extern inline void add_key(uint8_t key);
 extern inline void del_key(uint8_t key);
 extern inline void clear_keys(void);
@@ -54,9 +62,9 @@ int8_t get_oneshot_locked_mods(void) { return oneshot_locked_mods; }
 void set_oneshot_locked_mods(int8_t mods) { oneshot_locked_mods = mods; }
 void clear_oneshot_locked_mods(void) { oneshot_locked_mods = 0; }
 #if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-static int16_t oneshot_time = 0;
+static event_time_t oneshot_time = 0;
 bool has_oneshot_mods_timed_out(void) {
-  return TIMER_DIFF_16(timer_read(), oneshot_time) >= ONESHOT_TIMEOUT;
+  return event_timer_elapsed(oneshot_time) >= ONESHOT_TIMEOUT;
 }
 #else
 bool has_oneshot_mods_timed_out(void) {
@@ -79,9 +87,9 @@ inline uint8_t get_oneshot_layer(void) { return oneshot_layer_data >> 3; }
 inline uint8_t get_oneshot_layer_state(void) { return oneshot_layer_data & 0b111; }
 
 #if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-static int16_t oneshot_layer_time = 0;
+static event_time_t oneshot_layer_time = 0;
 inline bool has_oneshot_layer_timed_out() {
-    return TIMER_DIFF_16(timer_read(), oneshot_layer_time) >= ONESHOT_TIMEOUT &&
+    return event_timer_elapsed(oneshot_layer_time) >= ONESHOT_TIMEOUT &&
         !(get_oneshot_layer_state() & ONESHOT_TOGGLED);
 }
 #endif
@@ -95,7 +103,7 @@ void set_oneshot_layer(uint8_t layer, uint8_t state)
     oneshot_layer_data = layer << 3 | state;
     layer_on(layer);
 #if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-    oneshot_layer_time = timer_read();
+    oneshot_layer_time = event_timer_read();
 #endif
 }
 /** \brief Reset oneshot layer 
@@ -155,10 +163,86 @@ void send_keyboard_report(void) {
         }
     }
 
+#endif
+#ifdef QMK_ALL_KEYS_PER_SCAN
+    if (report_batching) {
+        send_keyboard_report_batched();
+        return;
+    }
 #endif
     host_keyboard_send(keyboard_report);
 }
 
+#ifdef QMK_ALL_KEYS_PER_SCAN
+/** \brief Start keyboard report batch
+ *
+ * Until the batch is ended, reports that only add (or only remove) keys and
+ * mods are merged into a single pending report. A report that changes
+ * direction flushes the pending one first, so no press or release is lost.
+ */
+void keyboard_report_batch_start(void)
+{
+    report_batching = true;
+    report_batch_dir = 0;
+    last_sent_report = *keyboard_report;
+}
+
+/** \brief Flush keyboard report batch
+ *
+ * Sends the pending report, if any, and keeps batching.
+ */
+void keyboard_report_batch_flush(void)
+{
+    if (report_batch_dir) {
+        host_keyboard_send(&pending_report);
+        last_sent_report = pending_report;
+        report_batch_dir = 0;
+    }
+}
+
+/** \brief End keyboard report batch
+ *
+ * Sends the pending report, if any, and stops batching.
+ */
+void keyboard_report_batch_end(void)
+{
+    keyboard_report_batch_flush();
+    report_batching = false;
+}
+
+static int8_t report_direction(report_keyboard_t *from, report_keyboard_t *to)
+{
+    bool grown = is_report_subset(from, to);
+    bool shrunk = is_report_subset(to, from);
+    if (grown && shrunk) return 0;
+    if (grown) return 1;
+    if (shrunk) return -1;
+    return 2;
+}
+
+static void send_keyboard_report_batched(void)
+{
+    if (report_batch_dir) {
+        int8_t dir = report_direction(&pending_report, keyboard_report);
+        if (dir == 0) return;
+        if (dir == report_batch_dir) {
+            pending_report = *keyboard_report;
+            return;
+        }
+        keyboard_report_batch_flush();
+    }
+    int8_t dir = report_direction(&last_sent_report, keyboard_report);
+    if (dir == 0) return;
+    if (dir == 2) {
+        host_keyboard_send(keyboard_report);
+        last_sent_report = *keyboard_report;
+        return;
+    }
+    pending_report = *keyboard_report;
+    report_batch_dir = dir;
+}
+#endif
+
 /** \brief Get mods
  *
  * FIXME: needs doc
@@ -247,7 +331,7 @@ void set_oneshot_mods(uint8_t mods)
 {
     oneshot_mods = mods;
 #if (defined(ONESHOT_TIMEOUT) && (ONESHOT_TIMEOUT > 0))
-    oneshot_time = timer_read();
+    oneshot_time = event_timer_read();
 #endif
 }
 /** \brief clear oneshot mods
@@ -28,6 +28,13 @@ extern report_keyboard_t *keyboard_report;
 
 void send_keyboard_report(void);
 
+#ifdef QMK_ALL_KEYS_PER_SCAN
+/* coalesce the reports of one scan */
+void keyboard_report_batch_start(void);
+void keyboard_report_batch_flush(void);
+void keyboard_report_batch_end(void);
+#endif
+
 /* key */
 inline void add_key(uint8_t key) {
   add_key_to_report(keyboard_report, key);
@@ -55,6 +55,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
     #include "audio.h"
 #endif /* AUDIO_ENABLE */
 
+#ifdef LATENCY_STATS_ENABLE
+    #include "latency_stats.h"
+#endif
+
+#ifdef PROFILE_ENABLE
+    #include "profile.h"
+#endif
+
 
 static bool command_common(uint8_t code);
 static void command_common_help(void);
@@ -535,6 +543,15 @@ static void command_console_help(void)
           "ESC/q:	quit\n"
 #ifdef MOUSEKEY_ENABLE
           "m:	mousekey\n"
+#endif
+#ifdef LATENCY_STATS_ENABLE
+          "l:	latency stats\n"
+#endif
+#ifdef PROFILE_ENABLE
+          "p:	main loop profile\n"
+#endif
+#if defined(LATENCY_STATS_ENABLE) || defined(PROFILE_ENABLE)
+          "r:	reset stats\n"
 #endif
     );
 }
@@ -556,6 +573,27 @@ static bool command_console(uint8_t code)
             print("M> ");
             command_state = MOUSEKEY;
             return true;
+#endif
+#ifdef LATENCY_STATS_ENABLE
+        case KC_L:
+            latency_stats_print();
+            break;
+#endif
+#ifdef PROFILE_ENABLE
+        case KC_P:
+            profile_print();
+            break;
+#endif
+#if defined(LATENCY_STATS_ENABLE) || defined(PROFILE_ENABLE)
+        case KC_R:
+#ifdef LATENCY_STATS_ENABLE
+            latency_stats_clear();
+#endif
+#ifdef PROFILE_ENABLE
+            profile_clear();
+#endif
+            print("\nstats: reset\n");
+            break;
 #endif
         default:
             print("?");
@@ -794,6 +832,6 @@ uint8_t numkey2num(uint8_t code)
 static void switch_default_layer(uint8_t layer)
 {
     xprintf("L%d\n", layer);
-    default_layer_set(1UL<<layer);
+    default_layer_set((layer_state_t)1 << layer);
     clear_keyboard();
 }
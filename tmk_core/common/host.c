@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "latency_stats.h"
 
 static host_driver_t *driver;
 static uint16_t last_system_report = 0;
@@ -46,6 +47,7 @@ uint8_t host_keyboard_leds(void)
 void host_keyboard_send(report_keyboard_t *report)
 {
     if (!driver) return;
+    latency_stats_report();
     (*driver->send_keyboard)(report);
 
     if (debug_keyboard) {
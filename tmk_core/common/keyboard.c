@@ -31,6 +31,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "eeconfig.h"
 #include "backlight.h"
 #include "action_layer.h"
+#include "action_util.h"
+#include "profile.h"
+#include "latency_stats.h"
 #ifdef BOOTMAGIC_ENABLE
 #   include "bootmagic.h"
 #else
@@ -72,6 +75,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef HD44780_ENABLE
 #   include "hd44780.h"
 #endif
+#ifdef POSITIONAL_COMBO_ENABLE
+#   include "process_positional_combo.h"
+#endif
 
 #ifdef MATRIX_HAS_GHOST
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
@@ -120,6 +126,74 @@ static inline bool has_ghost_in_row(uint8_t row, matrix_row_t rowdata)
 
 #endif
 
+#if defined(QMK_ALL_KEYS_PER_SCAN) && defined(KEY_EVENT_QUEUE_SIZE)
+#   error "KEY_EVENT_QUEUE_SIZE is not needed with QMK_ALL_KEYS_PER_SCAN"
+#endif
+
+#if defined(QMK_ALL_KEYS_PER_SCAN) || defined(KEY_EVENT_QUEUE_SIZE)
+static inline uint8_t matrix_row_lsb(matrix_row_t row)
+{
+#if (MATRIX_COLS <= 8)
+    return bitlsb(row);
+#elif (MATRIX_COLS <= 16)
+    return bitlsb16(row);
+#else
+    return bitlsb32(row);
+#endif
+}
+#endif
+
+#if defined(LATENCY_STATS_ENABLE) && !defined(QMK_ALL_KEYS_PER_SCAN) && !defined(KEY_EVENT_QUEUE_SIZE)
+#   define LATENCY_STATS_SCAN
+/* whether the matrix has edges not dispatched yet */
+static bool matrix_has_edges(const matrix_row_t *matrix_prev)
+{
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        if (matrix_get_row(r) != matrix_prev[r]) return true;
+    }
+    return false;
+}
+#endif
+
+#ifdef KEY_EVENT_QUEUE_SIZE
+#if (KEY_EVENT_QUEUE_SIZE & (KEY_EVENT_QUEUE_SIZE - 1)) || KEY_EVENT_QUEUE_SIZE > 128
+#   error "KEY_EVENT_QUEUE_SIZE must be a power of two no larger than 128"
+#endif
+#define KEY_EVENT_QUEUE_MASK (KEY_EVENT_QUEUE_SIZE - 1)
+
+#ifdef QMK_KEYS_PER_SCAN
+#   define KEY_EVENT_QUEUE_DRAIN QMK_KEYS_PER_SCAN
+#else
+#   define KEY_EVENT_QUEUE_DRAIN 1
+#endif
+
+/* Key events stamped at the scan that saw the edge, waiting for action_exec.
+ * head and tail run freely and are masked on access, so tail - head is the
+ * number of queued events.
+ */
+static keyevent_t key_event_queue[KEY_EVENT_QUEUE_SIZE];
+static uint8_t key_event_queue_head = 0;
+static uint8_t key_event_queue_tail = 0;
+
+static inline bool key_event_queue_push(keyevent_t event)
+{
+    if ((uint8_t)(key_event_queue_tail - key_event_queue_head) == KEY_EVENT_QUEUE_SIZE) {
+        return false;
+    }
+    key_event_queue[key_event_queue_tail++ & KEY_EVENT_QUEUE_MASK] = event;
+    return true;
+}
+
+static inline bool key_event_queue_pop(keyevent_t *event)
+{
+    if (key_event_queue_head == key_event_queue_tail) {
+        return false;
+    }
+    *event = key_event_queue[key_event_queue_head++ & KEY_EVENT_QUEUE_MASK];
+    return true;
+}
+#endif
+
 /** \brief matrix_setup
  *
  * FIXME: needs doc
@@ -212,12 +286,33 @@ void keyboard_task(void)
     static uint8_t led_status = 0;
     matrix_row_t matrix_row = 0;
     matrix_row_t matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
+#if defined(QMK_ALL_KEYS_PER_SCAN)
+    bool keys_processed = false;
+    event_time_t scan_time;
+#elif defined(KEY_EVENT_QUEUE_SIZE)
+    uint8_t keys_processed = 0;
+    event_time_t scan_time;
+    keyevent_t event;
+#elif defined(QMK_KEYS_PER_SCAN)
     uint8_t keys_processed = 0;
 #endif
 
+    PROFILE_START(MATRIX_SCAN);
     matrix_scan();
+    PROFILE_STOP(MATRIX_SCAN);
+#ifdef QMK_ALL_KEYS_PER_SCAN
+    // every event of this scan shares one timestamp
+    scan_time = event_timer_stamp(); /* time should not be 0 */
+    keyboard_report_batch_start();
+#elif defined(KEY_EVENT_QUEUE_SIZE)
+    // edges are stamped when they are seen, not when they are dispatched
+    scan_time = event_timer_stamp(); /* time should not be 0 */
+#endif
     if (is_keyboard_master()) {
+#ifdef LATENCY_STATS_SCAN
+        // edges dispatched over several scans are stamped by the first one
+        latency_stats_scan(matrix_has_edges(matrix_prev));
+#endif
         for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
             matrix_row = matrix_get_row(r);
             matrix_change = matrix_row ^ matrix_prev[r];
@@ -237,12 +332,41 @@ void keyboard_task(void)
                 //matrix_ghost[r] = matrix_row;
 #endif
                 if (debug_matrix) matrix_print();
+#ifdef QMK_ALL_KEYS_PER_SCAN
+                // visit only the changed columns, lowest first
+                do {
+                    uint8_t c = matrix_row_lsb(matrix_change);
+                    action_exec((keyevent_t){
+                        .key = (keypos_t){ .row = r, .col = c },
+                        .pressed = (matrix_row & ((matrix_row_t)1<<c)),
+                        .time = scan_time
+                    });
+                    matrix_change &= matrix_change - 1;
+                } while (matrix_change);
+                matrix_prev[r] = matrix_row;
+                keys_processed = true;
+#elif defined(KEY_EVENT_QUEUE_SIZE)
+                // queue every edge of the row; a full queue leaves the
+                // remaining edges in matrix_prev for a later scan
+                do {
+                    uint8_t c = matrix_row_lsb(matrix_change);
+                    if (!key_event_queue_push((keyevent_t){
+                        .key = (keypos_t){ .row = r, .col = c },
+                        .pressed = (matrix_row & ((matrix_row_t)1<<c)),
+                        .time = scan_time
+                    })) {
+                        break;
+                    }
+                    matrix_prev[r] ^= ((matrix_row_t)1<<c);
+                    matrix_change &= matrix_change - 1;
+                } while (matrix_change);
+#else
                 for (uint8_t c = 0; c < MATRIX_COLS; c++) {
                     if (matrix_change & ((matrix_row_t)1<<c)) {
                         action_exec((keyevent_t){
                             .key = (keypos_t){ .row = r, .col = c },
                             .pressed = (matrix_row & ((matrix_row_t)1<<c)),
-                            .time = (timer_read() | 1) /* time should not be 0 */
+                            .time = event_timer_stamp() /* time should not be 0 */
                         });
                         // record a processed key
                         matrix_prev[r] ^= ((matrix_row_t)1<<c);
@@ -254,56 +378,96 @@ void keyboard_task(void)
                         goto MATRIX_LOOP_END;
                     }
                 }
+#endif
             }
         }
+#ifdef KEY_EVENT_QUEUE_SIZE
+        // dispatch the oldest queued events
+        while (keys_processed < KEY_EVENT_QUEUE_DRAIN && key_event_queue_pop(&event)) {
+            action_exec(event);
+            keys_processed++;
+        }
+#endif
     }
     // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
+#if defined(QMK_KEYS_PER_SCAN) || defined(QMK_ALL_KEYS_PER_SCAN) || defined(KEY_EVENT_QUEUE_SIZE)
     // we can get here with some keys processed now.
     if (!keys_processed)
 #endif
     action_exec(TICK);
+#ifdef QMK_ALL_KEYS_PER_SCAN
+    keyboard_report_batch_end();
+#elif !defined(KEY_EVENT_QUEUE_SIZE)
 
 MATRIX_LOOP_END:
+#endif
+
+#ifdef LATENCY_STATS_SCAN
+    // the stamp is kept only for edges still waiting for a later scan
+    latency_stats_scan(matrix_has_edges(matrix_prev));
+#endif
+
+#ifdef POSITIONAL_COMBO_ENABLE
+    // replay the keys positional combos held back, outside action_exec
+    positional_combo_task();
+#endif
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
+    PROFILE_START(MOUSEKEY);
     mousekey_task();
+    PROFILE_STOP(MOUSEKEY);
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
+    PROFILE_START(PS2_MOUSE);
     ps2_mouse_task();
+    PROFILE_STOP(PS2_MOUSE);
 #endif
 
 #ifdef SERIAL_MOUSE_ENABLE
+    PROFILE_START(SERIAL_MOUSE);
     serial_mouse_task();
+    PROFILE_STOP(SERIAL_MOUSE);
 #endif
 
 #ifdef ADB_MOUSE_ENABLE
+    PROFILE_START(ADB_MOUSE);
     adb_mouse_task();
+    PROFILE_STOP(ADB_MOUSE);
 #endif
 
 #ifdef SERIAL_LINK_ENABLE
-	serial_link_update();
+    PROFILE_START(SERIAL_LINK);
+    serial_link_update();
+    PROFILE_STOP(SERIAL_LINK);
 #endif
 
 #ifdef VISUALIZER_ENABLE
+    PROFILE_START(VISUALIZER);
     visualizer_update(default_layer_state, layer_state, visualizer_get_mods(), host_keyboard_leds());
+    PROFILE_STOP(VISUALIZER);
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
+    PROFILE_START(POINTING_DEVICE);
     pointing_device_task();
+    PROFILE_STOP(POINTING_DEVICE);
 #endif
 
 #ifdef MIDI_ENABLE
+    PROFILE_START(MIDI);
     midi_task();
+    PROFILE_STOP(MIDI);
 #endif
 
     // update LED
+    PROFILE_START(LED);
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+    PROFILE_STOP(LED);
 }
 
 /** \brief keyboard set leds
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "timer.h"
 
 
 #ifdef __cplusplus
@@ -36,7 +37,7 @@ typedef struct {
 typedef struct {
     keypos_t key;
     bool     pressed;
-    uint16_t time;
+    event_time_t time;
 } keyevent_t;
 
 /* equivalent test of keypos_t */
@@ -52,9 +53,9 @@ static inline bool IS_RELEASED(keyevent_t event) { return (!IS_NOEVENT(event) &&
 
 /* Tick event */
 #define TICK                    (keyevent_t){           \
-    .key = (keypos_t){ .row = 255, .col = 255 },           \
+    .key = (keypos_t){ .col = 255, .row = 255 },           \
     .pressed = false,                                   \
-    .time = (timer_read() | 1)                          \
+    .time = event_timer_stamp()                         \
 }
 
 /* it runs once at early stage of startup before keyboard_init. */
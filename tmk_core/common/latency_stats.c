@@ -0,0 +1,156 @@
+/*
+Copyright 2018 QMK contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdbool.h>
+#include <string.h>
+#include "latency_stats.h"
+#include "action.h"
+#include "action_util.h"
+#include "action_tapping.h"
+#include "timer.h"
+#include "util.h"
+#include "print.h"
+
+#ifdef NO_ACTION_TAPPING
+#define action_tapping_holds_events() false
+#endif
+
+static latency_stats_t stats;
+// scan that saw the matrix edges not dispatched yet
+static event_time_t edge_time;
+static bool edges_pending = false;
+// detection time of the oldest event not yet seen in a report
+static event_time_t pending_time;
+static bool pending = false;
+// the keyboard report as it was before the pending event
+static report_keyboard_t pending_report;
+
+/** \brief latency stats scan
+ *
+ * Called by keyboard_task() before and after it dispatches the keys of a
+ * scan, when it dispatches a limited number per scan, with whether the
+ * matrix holds edges not dispatched yet. Edges left for later scans are
+ * stamped with the first scan that saw them rather than the scan that
+ * dispatches them.
+ */
+void latency_stats_scan(bool edges)
+{
+    if (!edges) {
+        edges_pending = false;
+    } else if (!edges_pending) {
+        edge_time = event_timer_stamp();
+        edges_pending = true;
+    }
+}
+
+/** \brief latency stats event
+ *
+ * Stamps the oldest event that has not been reported yet. Later events are
+ * folded into the same measurement, as they reach the host in the same report
+ * at the earliest.
+ */
+void latency_stats_event(keyevent_t event)
+{
+    if (IS_NOEVENT(event) || pending) return;
+    // the earlier stamp: a replayed event can be older than the edges
+    pending_time = (edges_pending && (int16_t)(event.time - edge_time) > 0) ? edge_time : event.time;
+    pending_report = *keyboard_report;
+    pending = true;
+}
+
+/** \brief latency stats event done
+ *
+ * Called once action_exec() has handled an event or tick. While tapping
+ * holds presses back the measurement stays open, so they are charged to the
+ * report that finally sends them. Once nothing is held, a measurement that
+ * left the keyboard report as it was (a layer key, a tap key that became a
+ * layer hold) is dropped, so it cannot be charged with the time until some
+ * later, unrelated report.
+ */
+void latency_stats_event_done(void)
+{
+    if (pending && !action_tapping_holds_events() &&
+            memcmp(keyboard_report, &pending_report, sizeof(pending_report)) == 0) {
+        pending = false;
+    }
+}
+
+/** \brief latency stats report
+ *
+ * Records the time from the pending event to this report.
+ */
+void latency_stats_report(void)
+{
+    if (!pending) return;
+    pending = false;
+
+    // event times are odd-stamped, so they can be up to 1ms in the future
+    int16_t diff = (int16_t)(event_timer_read() - pending_time);
+    uint16_t latency = diff > 0 ? diff : 0;
+    uint8_t bucket = latency ? biton16(latency) + 1 : 0;
+    if (bucket >= LATENCY_STATS_BUCKETS) {
+        bucket = LATENCY_STATS_BUCKETS - 1;
+    }
+
+    if (stats.buckets[bucket] < UINT16_MAX) stats.buckets[bucket]++;
+    if (stats.count < UINT16_MAX) stats.count++;
+    if (latency > stats.max) stats.max = latency;
+}
+
+/** \brief latency stats clear
+ *
+ * Empties the histogram and forgets any pending event.
+ */
+void latency_stats_clear(void)
+{
+    for (uint8_t i = 0; i < LATENCY_STATS_BUCKETS; i++) {
+        stats.buckets[i] = 0;
+    }
+    stats.count = 0;
+    stats.max = 0;
+    pending = false;
+    edges_pending = false;
+}
+
+/** \brief latency stats get
+ *
+ * Returns the histogram, e.g. to send it over raw HID.
+ */
+const latency_stats_t *latency_stats_get(void)
+{
+    return &stats;
+}
+
+/** \brief latency stats print
+ *
+ * Prints the histogram to the console.
+ */
+void latency_stats_print(void)
+{
+    print("\n\t- Latency (ms) -\n");
+    for (uint8_t i = 0; i < LATENCY_STATS_BUCKETS; i++) {
+        if (i == 0) {
+            print("0");
+        } else if (i == LATENCY_STATS_BUCKETS - 1) {
+            print(">="); print_dec(1 << (i - 1));
+        } else {
+            print_dec(1 << (i - 1)); print("-"); print_dec((1 << i) - 1);
+        }
+        print(": "); print_dec(stats.buckets[i]); print("\n");
+    }
+    print("count: "); print_dec(stats.count); print("\n");
+    print("max: "); print_dec(stats.max); print("\n");
+}
@@ -0,0 +1,70 @@
+/*
+Copyright 2018 QMK contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+/* A measurement runs from the scan that saw a key edge to the first keyboard
+ * report handed to the host driver after it. A press that tapping holds back
+ * stays open until the report that finally sends it, so a tap is measured
+ * from its press. Events that leave the keyboard report as it was once
+ * nothing is held back, like a layer key, are not measured.
+ *
+ * Bucket n counts latencies in [2^(n-1), 2^n) ms, bucket 0 counts 0 ms and
+ * the last bucket also counts everything above its range. */
+#ifndef LATENCY_STATS_BUCKETS
+#define LATENCY_STATS_BUCKETS 8
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t buckets[LATENCY_STATS_BUCKETS];
+    uint16_t count;
+    uint16_t max;
+} latency_stats_t;
+
+#ifdef LATENCY_STATS_ENABLE
+/* keyboard_task() sees edges in the matrix it has not dispatched yet */
+void latency_stats_scan(bool edges);
+/* an event was detected by the matrix scan */
+void latency_stats_event(keyevent_t event);
+/* action_exec() is done with the event or tick */
+void latency_stats_event_done(void);
+/* a keyboard report is being handed to the host driver */
+void latency_stats_report(void);
+void latency_stats_clear(void);
+const latency_stats_t *latency_stats_get(void);
+void latency_stats_print(void);
+#else
+#define latency_stats_scan(edges)
+#define latency_stats_event(event)
+#define latency_stats_event_done()
+#define latency_stats_report()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+/*
+Copyright 2018 QMK contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "profile.h"
+#include "timer.h"
+#include "print.h"
+
+#if defined(__AVR__)
+#   include <avr/io.h>
+#   include <util/atomic.h>
+#   define PROFILE_TICKS_PER_MS TIMER_RAW_TOP
+#elif defined(PROTOCOL_CHIBIOS)
+#   include "ch.h"
+#   define PROFILE_TICKS_PER_MS (CH_CFG_ST_FREQUENCY / 1000)
+#else
+#   define PROFILE_TICKS_PER_MS 1
+#endif
+
+static uint16_t start_time[PROFILE_STAGES];
+// a stage entered again before it stops is timed from its outermost start
+static uint8_t depth[PROFILE_STAGES];
+static profile_stat_t stats[PROFILE_STAGES];
+
+/** \brief profile read
+ *
+ * Returns the finest timestamp the platform offers: Timer0 counts on AVR
+ * (a few microseconds), system ticks on ChibiOS and milliseconds elsewhere.
+ */
+uint16_t profile_read(void)
+{
+#if defined(__AVR__)
+    uint32_t ms;
+    uint8_t raw;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = timer_count;
+        raw = TIMER_RAW;
+        // Timer0 has wrapped but the millisecond interrupt has not run yet
+#ifndef __AVR_ATmega32A__
+        if ((TIFR0 & _BV(OCF0A)) && raw < TIMER_RAW_TOP / 2) ms++;
+#else
+        if ((TIFR & _BV(OCF0)) && raw < TIMER_RAW_TOP / 2) ms++;
+#endif
+    }
+    return (uint16_t)ms * TIMER_RAW_TOP + raw;
+#elif defined(PROTOCOL_CHIBIOS)
+    return (uint16_t)chVTGetSystemTimeX();
+#else
+    return timer_read();
+#endif
+}
+
+uint16_t profile_ticks_per_ms(void)
+{
+    return PROFILE_TICKS_PER_MS;
+}
+
+void profile_start(profile_stage_t stage)
+{
+    if (depth[stage]++ == 0) {
+        start_time[stage] = profile_read();
+    }
+}
+
+void profile_stop(profile_stage_t stage)
+{
+    if (depth[stage] == 0 || --depth[stage] != 0) return;
+
+    uint16_t elapsed = profile_read() - start_time[stage];
+    profile_stat_t *stat = &stats[stage];
+    if (stat->count == 0 || elapsed < stat->min) stat->min = elapsed;
+    if (elapsed > stat->max) stat->max = elapsed;
+    stat->total += elapsed;
+    stat->count++;
+}
+
+void profile_clear(void)
+{
+    for (uint8_t i = 0; i < PROFILE_STAGES; i++) {
+        stats[i] = (profile_stat_t){};
+    }
+}
+
+const profile_stat_t *profile_get(profile_stage_t stage)
+{
+    return &stats[stage];
+}
+
+static void print_stage_name(profile_stage_t stage)
+{
+    switch (stage) {
+        case PROFILE_MATRIX_SCAN:       print("matrix_scan"); break;
+        case PROFILE_MUSIC:             print(" music"); break;
+        case PROFILE_TAP_DANCE:         print(" tap_dance"); break;
+        case PROFILE_COMBO:             print(" combo"); break;
+        case PROFILE_BACKLIGHT:         print(" backlight"); break;
+        case PROFILE_RGB_MATRIX:        print(" rgb_matrix"); break;
+        case PROFILE_MATRIX_SCAN_KB:    print(" matrix_scan_kb"); break;
+        case PROFILE_ACTION_EXEC:       print("action_exec"); break;
+        case PROFILE_MOUSEKEY:          print("mousekey"); break;
+        case PROFILE_PS2_MOUSE:         print("ps2_mouse"); break;
+        case PROFILE_SERIAL_MOUSE:      print("serial_mouse"); break;
+        case PROFILE_ADB_MOUSE:         print("adb_mouse"); break;
+        case PROFILE_SERIAL_LINK:       print("serial_link"); break;
+        case PROFILE_VISUALIZER:        print("visualizer"); break;
+        case PROFILE_POINTING_DEVICE:   print("pointing_device"); break;
+        case PROFILE_MIDI:              print("midi"); break;
+        case PROFILE_LED:               print("led"); break;
+        case PROFILE_RGBLIGHT:          print("rgblight"); break;
+#ifdef PROFILE_PROCESSORS
+        case PROFILE_PROCESS_RECORD:        print("process_record"); break;
+        case PROFILE_PROCESS_KEY_LOCK:      print(" key_lock"); break;
+        case PROFILE_PROCESS_CLICKY:        print(" clicky"); break;
+        case PROFILE_PROCESS_RECORD_KB:     print(" process_record_kb"); break;
+        case PROFILE_PROCESS_RGB_MATRIX:    print(" rgb_matrix"); break;
+        case PROFILE_PROCESS_MIDI:          print(" midi"); break;
+        case PROFILE_PROCESS_AUDIO:         print(" audio"); break;
+        case PROFILE_PROCESS_STENO:         print(" steno"); break;
+        case PROFILE_PROCESS_MUSIC:         print(" music"); break;
+        case PROFILE_PROCESS_TAP_DANCE:     print(" tap_dance"); break;
+        case PROFILE_PROCESS_LEADER:        print(" leader"); break;
+        case PROFILE_PROCESS_CHORDING:      print(" chording"); break;
+        case PROFILE_PROCESS_COMBO:         print(" combo"); break;
+        case PROFILE_PROCESS_UNICODE:       print(" unicode"); break;
+        case PROFILE_PROCESS_UCIS:          print(" ucis"); break;
+        case PROFILE_PROCESS_PRINTER:       print(" printer"); break;
+        case PROFILE_PROCESS_AUTO_SHIFT:    print(" auto_shift"); break;
+        case PROFILE_PROCESS_UNICODE_MAP:   print(" unicode_map"); break;
+        case PROFILE_PROCESS_TERMINAL:      print(" terminal"); break;
+#endif
+        default:                        break;
+    }
+}
+
+/** \brief profile print
+ *
+ * Prints count, min, mean and max in microseconds for every stage that ran.
+ * Indented stages are part of the stage above them.
+ */
+void profile_print(void)
+{
+    print("\n\t- Profile (us) -\n");
+    for (uint8_t i = 0; i < PROFILE_STAGES; i++) {
+        const profile_stat_t *stat = &stats[i];
+        if (!stat->count) continue;
+        print_stage_name(i);
+        xprintf(": n=%lu min=%lu mean=%lu max=%lu\n",
+                stat->count,
+                (uint32_t)stat->min * 1000 / PROFILE_TICKS_PER_MS,
+                // mean in whole ticks first, so no 64-bit divide is needed
+                (stat->total + stat->count / 2) / stat->count * 1000 / PROFILE_TICKS_PER_MS,
+                (uint32_t)stat->max * 1000 / PROFILE_TICKS_PER_MS);
+    }
+}
@@ -0,0 +1,113 @@
+/*
+Copyright 2018 QMK contributors
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+/* PROFILE_PROCESSORS adds a stage per record processor */
+#ifndef PROFILE_ENABLE
+#undef PROFILE_PROCESSORS
+#endif
+
+/* Main loop stages timed by PROFILE_START/PROFILE_STOP */
+typedef enum {
+    PROFILE_MATRIX_SCAN,
+    PROFILE_MUSIC,
+    PROFILE_TAP_DANCE,
+    PROFILE_COMBO,
+    PROFILE_BACKLIGHT,
+    PROFILE_RGB_MATRIX,
+    PROFILE_MATRIX_SCAN_KB,
+    PROFILE_ACTION_EXEC,
+    PROFILE_MOUSEKEY,
+    PROFILE_PS2_MOUSE,
+    PROFILE_SERIAL_MOUSE,
+    PROFILE_ADB_MOUSE,
+    PROFILE_SERIAL_LINK,
+    PROFILE_VISUALIZER,
+    PROFILE_POINTING_DEVICE,
+    PROFILE_MIDI,
+    PROFILE_LED,
+    PROFILE_RGBLIGHT,
+#ifdef PROFILE_PROCESSORS
+    PROFILE_PROCESS_RECORD,
+    PROFILE_PROCESS_KEY_LOCK,
+    PROFILE_PROCESS_CLICKY,
+    PROFILE_PROCESS_RECORD_KB,
+    PROFILE_PROCESS_RGB_MATRIX,
+    PROFILE_PROCESS_MIDI,
+    PROFILE_PROCESS_AUDIO,
+    PROFILE_PROCESS_STENO,
+    PROFILE_PROCESS_MUSIC,
+    PROFILE_PROCESS_TAP_DANCE,
+    PROFILE_PROCESS_LEADER,
+    PROFILE_PROCESS_CHORDING,
+    PROFILE_PROCESS_COMBO,
+    PROFILE_PROCESS_UNICODE,
+    PROFILE_PROCESS_UCIS,
+    PROFILE_PROCESS_PRINTER,
+    PROFILE_PROCESS_AUTO_SHIFT,
+    PROFILE_PROCESS_UNICODE_MAP,
+    PROFILE_PROCESS_TERMINAL,
+#endif
+    PROFILE_STAGES
+} profile_stage_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t total;
+    uint16_t min;
+    uint16_t max;
+} profile_stat_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef PROFILE_ENABLE
+#define PROFILE_START(stage)    profile_start(PROFILE_##stage)
+#define PROFILE_STOP(stage)     profile_stop(PROFILE_##stage)
+
+/* free running tick counter, profile_ticks_per_ms() ticks per millisecond */
+uint16_t profile_read(void);
+uint16_t profile_ticks_per_ms(void);
+
+void profile_start(profile_stage_t stage);
+void profile_stop(profile_stage_t stage);
+void profile_clear(void);
+const profile_stat_t *profile_get(profile_stage_t stage);
+void profile_print(void);
+#else
+#define PROFILE_START(stage)
+#define PROFILE_STOP(stage)
+#endif
+
+#ifdef PROFILE_PROCESSORS
+#define PROFILE_PROCESS_START(stage)    profile_start(PROFILE_PROCESS_##stage)
+#define PROFILE_PROCESS_STOP(stage)     profile_stop(PROFILE_PROCESS_##stage)
+#else
+#define PROFILE_PROCESS_START(stage)
+#define PROFILE_PROCESS_STOP(stage)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -241,3 +241,57 @@ void clear_keys_from_report(report_keyboard_t* keyboard_report)
         keyboard_report->raw[i] = 0;
     }
 }
+
+/** \brief is key in report
+ *
+ * Returns true when key is held in the report.
+ */
+bool is_key_in_report(report_keyboard_t* keyboard_report, uint8_t key)
+{
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        if ((key>>3) >= KEYBOARD_REPORT_BITS) {
+            return false;
+        }
+        return keyboard_report->nkro.bits[key>>3] & 1<<(key&7);
+    }
+#endif
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keyboard_report->keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief is report subset
+ *
+ * Returns true when every mod and key held in sub is also held in super.
+ */
+bool is_report_subset(report_keyboard_t* sub, report_keyboard_t* super)
+{
+    if (sub->mods & ~super->mods) {
+        return false;
+    }
+#ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if (sub->nkro.bits[i] & ~super->nkro.bits[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t key = sub->keys[i];
+        if (!key) continue;
+        uint8_t j = 0;
+        for (; j < KEYBOARD_REPORT_KEYS && super->keys[j] != key; j++)
+            ;
+        if (j == KEYBOARD_REPORT_KEYS) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define REPORT_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "keycode.h"
 
 
@@ -89,6 +90,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
     #define KEYBOARD_REPORT_SIZE NKRO_EPSIZE
     #define KEYBOARD_REPORT_KEYS (NKRO_EPSIZE - 2)
     #define KEYBOARD_REPORT_BITS (NKRO_EPSIZE - 1)
+  #elif defined(PROTOCOL_TEST)
+    #define KEYBOARD_REPORT_SIZE 32
+    #define KEYBOARD_REPORT_KEYS (32 - 2)
+    #define KEYBOARD_REPORT_BITS (32 - 1)
   #else
     #error "NKRO not supported with this protocol"
 #endif
@@ -190,6 +195,8 @@ void del_key_bit(report_keyboard_t* keyboard_report, uint8_t code);
 void add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key);
 void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key);
 void clear_keys_from_report(report_keyboard_t* keyboard_report);
+bool is_key_in_report(report_keyboard_t* keyboard_report, uint8_t key);
+bool is_report_subset(report_keyboard_t* sub, report_keyboard_t* super);
 
 #ifdef __cplusplus
 }
@@ -31,6 +31,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define TIMER_DIFF_32(a, b)     TIMER_DIFF(a, b, UINT32_MAX)
 #define TIMER_DIFF_RAW(a, b)    TIMER_DIFF_8(a, b)
 
+/* Event time
+ *
+ * Key event timestamps and the timers compared against them (tapping,
+ * combo, tap dance and oneshot) are 16 bits by default and alias after
+ * about 65 seconds. EVENT_TIME_32BIT widens them to the 32 bit timer.
+ */
+#ifdef EVENT_TIME_32BIT
+typedef uint32_t event_time_t;
+#define event_timer_read()      timer_read32()
+#define TIMER_DIFF_EVENT(a, b)  TIMER_DIFF_32(a, b)
+#else
+typedef uint16_t event_time_t;
+#define event_timer_read()      timer_read()
+#define TIMER_DIFF_EVENT(a, b)  TIMER_DIFF_16(a, b)
+#endif
+/* timestamp that is never 0, which is reserved for "no event" */
+#define event_timer_stamp()     (event_timer_read() | 1)
+#define event_timer_elapsed(last)   TIMER_DIFF_EVENT(event_timer_read(), (event_time_t)(last))
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -36,6 +36,19 @@ uint8_t biton(uint8_t bits);
 uint8_t biton16(uint16_t bits);
 uint8_t biton32(uint32_t bits);
 
+// least significant on-bit - return lowest location of on-bit
+// NOTE: undefined when all bits are off
+static inline uint8_t bitlsb(uint8_t bits) { return __builtin_ctz(bits); }
+static inline uint8_t bitlsb16(uint16_t bits) { return __builtin_ctz(bits); }
+static inline uint8_t bitlsb32(uint32_t bits) { return __builtin_ctzl(bits); }
+
+// most significant on-bit - return highest location of on-bit
+// NOTE: undefined when all bits are off
+static inline uint8_t bitmsb(uint8_t bits) { return sizeof(unsigned int) * 8 - 1 - __builtin_clz(bits); }
+static inline uint8_t bitmsb16(uint16_t bits) { return sizeof(unsigned int) * 8 - 1 - __builtin_clz(bits); }
+static inline uint8_t bitmsb32(uint32_t bits) { return sizeof(unsigned long) * 8 - 1 - __builtin_clzl(bits); }
+static inline uint8_t bitmsb64(uint64_t bits) { return 63 - __builtin_clzll(bits); }
+
 uint8_t  bitrev(uint8_t bits);
 uint16_t bitrev16(uint16_t bits);
 uint32_t bitrev32(uint32_t bits);
@@ -48,6 +48,7 @@
 #include "sleep_led.h"
 #endif
 #include "suspend.h"
+#include "profile.h"
 
 #include "usb_descriptor.h"
 #include "lufa.h"
@@ -1075,7 +1076,9 @@ int main(void)
 #endif
 
 #if defined(RGBLIGHT_ANIMATIONS) & defined(RGBLIGHT_ENABLE)
+        PROFILE_START(RGBLIGHT);
         rgblight_task();
+        PROFILE_STOP(RGBLIGHT);
 #endif
 
 #ifdef MODULE_ADAFRUIT_BLE
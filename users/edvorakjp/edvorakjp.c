@@ -2,7 +2,7 @@
 #include "edvorakjp.h"
 
 bool japanese_mode;
-uint16_t time_on_pressed;
+event_time_t time_on_pressed;
 
 edvorakjp_config_t edvorakjp_config;
 
@@ -195,7 +195,7 @@ bool process_record_layer(uint16_t keycode, keyrecord_t *record) {
       } else {
         layer_off(_LOWER);
 
-        if (TIMER_DIFF_16(record->event.time, time_on_pressed) < TAPPING_TERM) {
+        if (TIMER_DIFF_EVENT(record->event.time, time_on_pressed) < TAPPING_TERM) {
           update_japanese_mode(false);
         }
         time_on_pressed = 0;
@@ -208,7 +208,7 @@ bool process_record_layer(uint16_t keycode, keyrecord_t *record) {
       } else {
         layer_off(_RAISE);
 
-        if (TIMER_DIFF_16(record->event.time, time_on_pressed) < TAPPING_TERM) {
+        if (TIMER_DIFF_EVENT(record->event.time, time_on_pressed) < TAPPING_TERM) {
           update_japanese_mode(true);
         }
         time_on_pressed = 0;